@@ -0,0 +1,33 @@
+# cmake -DSPIRV_DIR=<dir> -DSHADER_NAMES=<name>,<name>,... -DOUTPUT=<header> -P embed_spirv.cmake
+string(REPLACE "," ";" SHADER_NAMES "${SHADER_NAMES}")
+
+set(CONTENT "// generated by add_glsl (cmake/glsl.cmake), do not edit\n")
+string(APPEND CONTENT "#ifndef EMBEDDED_SPIRV_H\n#define EMBEDDED_SPIRV_H\n\n")
+string(APPEND CONTENT "#include <vkfw/ShaderRegistry.h>\n\n#include <cstdint>\n\nnamespace\n{\n")
+
+foreach(SHADER_NAME ${SHADER_NAMES})
+    file(READ "${SPIRV_DIR}/${SHADER_NAME}.spv" SPIRV_HEX HEX)
+    string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+    math(EXPR SPIRV_HEX_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+    if(NOT SPIRV_HEX_REMAINDER EQUAL 0)
+        message(FATAL_ERROR "${SHADER_NAME}.spv isn't a sequence of 32-bit words")
+    endif()
+    # SPIR-V is a stream of little-endian 32-bit words
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])([0-9a-f][0-9a-f])" "0x\\4\\3\\2\\1u, " SPIRV_WORDS "${SPIRV_HEX}")
+    string(REGEX REPLACE "((0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, )(0x[0-9a-f]+u, ))" "\\1\n\t\t" SPIRV_WORDS "${SPIRV_WORDS}")
+    string(REPLACE ", \n" ",\n" SPIRV_WORDS "${SPIRV_WORDS}")
+    string(MAKE_C_IDENTIFIER "${SHADER_NAME}" SHADER_IDENTIFIER)
+    string(APPEND CONTENT "\tconstexpr uint32_t gc_${SHADER_IDENTIFIER}[] = {\n\t\t${SPIRV_WORDS}};\n\n")
+    list(APPEND EMBEDDED_SHADERS "\t\t{\"${SHADER_NAME}\", gc_${SHADER_IDENTIFIER}, sizeof(gc_${SHADER_IDENTIFIER}) / sizeof(uint32_t)},\n")
+endforeach()
+
+string(APPEND CONTENT "\tconstexpr vkfw::EmbeddedShader gc_embeddedShaders[] = {\n")
+foreach(EMBEDDED_SHADER ${EMBEDDED_SHADERS})
+    string(APPEND CONTENT "${EMBEDDED_SHADER}")
+endforeach()
+string(APPEND CONTENT "\t};\n\n}\n\n#endif\n")
+
+# only touch the header when it changes, so that dependents aren't needlessly rebuilt
+file(WRITE "${OUTPUT}.tmp" "${CONTENT}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -1,3 +1,16 @@
+option(VKFW_OPTIMIZE_SPIRV "Run the compiled SPIR-V through spirv-opt" OFF)
+set(VKFW_SPIRV_OPT_FLAGS "-O" CACHE STRING "spirv-opt flags (-O for performance, -Os for size)")
+option(VKFW_EMBED_SPIRV "Embed the compiled SPIR-V in the executable instead of loading it from disk" OFF)
+
+set(GLSL_CMAKE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+if(VKFW_OPTIMIZE_SPIRV)
+    find_program(SPIRV_OPT spirv-opt HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+    if(NOT SPIRV_OPT)
+        message(FATAL_ERROR "VKFW_OPTIMIZE_SPIRV is set but spirv-opt couldn't be found")
+    endif()
+endif()
+
 function(add_glsl)
     get_target_property(OUT_DIR ${ARGV0} RUNTIME_OUTPUT_DIRECTORY)
     set(SPIRV_DIR "${CMAKE_CURRENT_BINARY_DIR}/spirv")
@@ -7,20 +20,47 @@ function(add_glsl)
             list(GET ARGN ${ARG_IDX} GLSL)
             get_filename_component(GLSL_FILENAME ${GLSL} NAME)
             set(SPIRV "${SPIRV_DIR}/${GLSL_FILENAME}.spv")
-            add_custom_command(
-                OUTPUT ${SPIRV}
-                COMMAND ${CMAKE_COMMAND} -E make_directory "${SPIRV_DIR}"
-                COMMAND glslangValidator -V ${GLSL} -o ${SPIRV}
-                DEPENDS ${GLSL}
-            )
+            if(VKFW_OPTIMIZE_SPIRV)
+                separate_arguments(SPIRV_OPT_FLAGS UNIX_COMMAND "${VKFW_SPIRV_OPT_FLAGS}")
+                add_custom_command(
+                    OUTPUT ${SPIRV}
+                    COMMAND ${CMAKE_COMMAND} -E make_directory "${SPIRV_DIR}"
+                    COMMAND glslangValidator -V ${GLSL} -o ${SPIRV}.unoptimized
+                    COMMAND ${SPIRV_OPT} ${SPIRV_OPT_FLAGS} ${SPIRV}.unoptimized -o ${SPIRV}
+                    COMMAND ${CMAKE_COMMAND} -E remove ${SPIRV}.unoptimized
+                    DEPENDS ${GLSL}
+                )
+            else()
+                add_custom_command(
+                    OUTPUT ${SPIRV}
+                    COMMAND ${CMAKE_COMMAND} -E make_directory "${SPIRV_DIR}"
+                    COMMAND glslangValidator -V ${GLSL} -o ${SPIRV}
+                    DEPENDS ${GLSL}
+                )
+            endif()
             list(APPEND GLSL_SPIRV_FILES ${SPIRV})
+            list(APPEND GLSL_FILENAMES ${GLSL_FILENAME})
         endforeach(ARG_IDX)
+        if(VKFW_EMBED_SPIRV)
+            # every shader of the target ends up as a constexpr uint32_t array in a single header,
+            # see vkfw/ShaderRegistry.h
+            set(EMBEDDED_SPIRV_DIR "${CMAKE_CURRENT_BINARY_DIR}/embedded_spirv")
+            set(EMBEDDED_SPIRV_HEADER "${EMBEDDED_SPIRV_DIR}/embedded_spirv.h")
+            string(REPLACE ";" "," SHADER_NAMES "${GLSL_FILENAMES}")
+            add_custom_command(
+                OUTPUT ${EMBEDDED_SPIRV_HEADER}
+                COMMAND ${CMAKE_COMMAND} -DSPIRV_DIR=${SPIRV_DIR} -DSHADER_NAMES=${SHADER_NAMES} -DOUTPUT=${EMBEDDED_SPIRV_HEADER} -P "${GLSL_CMAKE_DIR}/embed_spirv.cmake"
+                DEPENDS ${GLSL_SPIRV_FILES} "${GLSL_CMAKE_DIR}/embed_spirv.cmake"
+            )
+            target_include_directories(${ARGV0} PRIVATE ${EMBEDDED_SPIRV_DIR})
+            target_compile_definitions(${ARGV0} PRIVATE VKFW_EMBED_SPIRV=1)
+        endif()
         add_custom_target(
             ${ARGV0}_GLSL_SPIRV_FILES
             COMMAND ${CMAKE_COMMAND} -E make_directory "${OUT_DIR}/$<CONFIG>/spirv"
             COMMAND ${CMAKE_COMMAND} -E copy_directory "${SPIRV_DIR}" "${OUT_DIR}/$<CONFIG>/spirv"
-            DEPENDS ${GLSL_SPIRV_FILES}
+            DEPENDS ${GLSL_SPIRV_FILES} ${EMBEDDED_SPIRV_HEADER}
         )
         add_dependencies(${ARGV0} ${ARGV0}_GLSL_SPIRV_FILES)
     endif()
-endfunction()
\ No newline at end of file
+endfunction()
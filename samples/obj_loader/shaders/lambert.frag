@@ -6,9 +6,11 @@ layout(location = 2) in vec3 fLightDir;
 
 layout(location = 0) out vec4 oColor;
 
+layout(constant_id = 0) const float c_ambient = 0;
+
 void main()
 {
     float NdotL = dot(fNormal, fLightDir);
     float attenuation = max(NdotL, 0);
-    oColor = vec4(vec3(attenuation), 1);
+    oColor = vec4(vec3(c_ambient + (1 - c_ambient) * attenuation), 1);
 }
\ No newline at end of file
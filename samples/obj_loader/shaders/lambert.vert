@@ -5,7 +5,16 @@ layout(set = 0, binding = 0) uniform uSceneConstants {
     mat4 projection;
 };
 
+layout(push_constant) uniform uDrawConstants {
+    mat4 model;
+    mat4 normal;
+};
+
+// positions are normalized (the dequantization is part of the model matrix), normals octahedral-encoded and uvs half-floats
+layout(constant_id = 0) const bool c_quantizedVertices = false;
+
 layout(location = 0) in vec3 vPosition;
+// .xy only if quantized
 layout(location = 1) in vec3 vNormal;
 layout(location = 2) in vec2 vUv;
 
@@ -13,11 +22,26 @@ layout(location = 0) out vec3 fNormal;
 layout(location = 1) out vec2 fUv;
 layout(location = 2) out vec3 fLightDir;
 
+vec2 signNotZero(vec2 v)
+{
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec3 decodeOctahedral(vec2 encodedNormal)
+{
+    vec3 decodedNormal = vec3(encodedNormal, 1.0 - abs(encodedNormal.x) - abs(encodedNormal.y));
+    if (decodedNormal.z < 0.0)
+    {
+        decodedNormal.xy = (1.0 - abs(decodedNormal.yx)) * signNotZero(decodedNormal.xy);
+    }
+    return normalize(decodedNormal);
+}
+
 void main()
 {
-    vec4 worldPosition = view * vec4(vPosition, 1.0);
-    gl_Position = projection * worldPosition;
-    fNormal = (inverse(view) * vec4(vNormal, 0.0)).xyz;
+    vec4 viewPosition = view * model * vec4(vPosition, 1.0);
+    gl_Position = projection * viewPosition;
+    fNormal = mat3(normal) * (c_quantizedVertices ? decodeOctahedral(vNormal.xy) : vNormal);
     fUv = vUv;
-    fLightDir = -normalize(worldPosition.xyz);
+    fLightDir = -normalize(viewPosition.xyz);
 }
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include "MeshCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    const char gc_meshCacheMagic[8] = {'O', 'B', 'J', 'C', 'A', 'C', 'H', 'E'};
+    constexpr uint32_t gc_meshCacheVersion = 5;
+    // so that vertices and indices can be used in place
+    constexpr uint64_t gc_meshCacheAlignment = 16;
+    constexpr size_t gc_hashBlockSize = 4 << 20;
+
+    struct MeshCacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t meshCount;
+        MeshCacheKey key;
+    };
+
+    struct MeshCacheEntry
+    {
+        uint64_t vertexOffset;
+        uint64_t vertexCount;
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        uint64_t indexRangeOffset;
+        uint64_t indexRangeCount;
+        uint64_t meshletOffset;
+        uint64_t meshletCount;
+        uint64_t lodOffset;
+        uint64_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+        float boundingRadius;
+        int32_t materialId;
+        uint32_t indexSize;
+    };
+
+    inline uint64_t align(uint64_t offset)
+    {
+        return (offset + gc_meshCacheAlignment - 1) & ~(gc_meshCacheAlignment - 1);
+    }
+
+    inline uint64_t mix(uint64_t hash, uint64_t value)
+    {
+        hash ^= value * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 29;
+        hash *= 0xbf58476d1ce4e5b9ull;
+        return hash ^ (hash >> 32);
+    }
+
+    uint64_t hashBlock(const char *data, size_t size)
+    {
+        uint64_t hash = size;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t value;
+            memcpy(&value, data + i, 8);
+            hash = mix(hash, value);
+        }
+        uint64_t remainder = 0;
+        memcpy(&remainder, data + i, size - i);
+        return mix(hash, remainder);
+    }
+
+    template <typename index_t>
+    bool areIndicesInRange(const index_t *indices, uint64_t indexCount, uint64_t vertexCount)
+    {
+        return std::all_of(indices, indices + indexCount, [vertexCount](index_t index)
+                           { return index < vertexCount; });
+    }
+
+    // whether every index in [firstIndex, firstIndex + indexCount), offset by baseVertex, refers to one of the mesh's vertices
+    // (the gpu would otherwise read past them, into whatever else shares the arena block)
+    bool areIndicesInRange(const MeshCacheMesh &mesh, uint64_t firstIndex, uint64_t indexCount, uint64_t baseVertex)
+    {
+        if (indexCount == 0)
+        {
+            return true;
+        }
+        if (baseVertex >= mesh.vertexCount)
+        {
+            return false;
+        }
+        if (mesh.indexSize == sizeof(uint16_t))
+        {
+            return areIndicesInRange(static_cast<const uint16_t *>(mesh.indices) + firstIndex, indexCount, mesh.vertexCount - baseVertex);
+        }
+        return areIndicesInRange(static_cast<const uint32_t *>(mesh.indices) + firstIndex, indexCount, mesh.vertexCount - baseVertex);
+    }
+
+}
+
+uint64_t hashMeshCacheSource(const char *data, size_t size, vkfw::ThreadPool &threadPool)
+{
+    std::vector<uint64_t> blockHashes((size + gc_hashBlockSize - 1) / gc_hashBlockSize);
+    threadPool.parallelFor(blockHashes.size(), [data, size, &blockHashes](size_t i)
+                           {
+        auto offset = i * gc_hashBlockSize;
+        blockHashes[i] = hashBlock(data + offset, std::min(gc_hashBlockSize, size - offset)); });
+    uint64_t hash = size;
+    for (auto blockHash : blockHashes)
+    {
+        hash = mix(hash, blockHash);
+    }
+    return hash;
+}
+
+bool writeMeshCache(const std::string &path, const MeshCacheKey &key, const std::vector<MeshCacheMesh> &meshes)
+{
+    MeshCacheHeader header;
+    memcpy(header.magic, gc_meshCacheMagic, sizeof(header.magic));
+    header.version = gc_meshCacheVersion;
+    header.meshCount = (uint32_t)meshes.size();
+    header.key = key;
+
+    std::vector<MeshCacheEntry> entries(meshes.size());
+    auto offset = align(sizeof(MeshCacheHeader) + sizeof(MeshCacheEntry) * entries.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto &mesh = meshes[i];
+        auto &entry = entries[i];
+        entry.vertexOffset = offset;
+        entry.vertexCount = mesh.vertexCount;
+        offset = align(offset + mesh.vertexCount * key.vertexStride);
+        entry.indexOffset = offset;
+        entry.indexCount = mesh.indexCount;
+        offset = align(offset + mesh.indexCount * mesh.indexSize);
+        entry.indexRangeOffset = offset;
+        entry.indexRangeCount = mesh.indexRangeCount;
+        offset = align(offset + mesh.indexRangeCount * sizeof(IndexRange));
+        entry.meshletOffset = offset;
+        entry.meshletCount = mesh.meshletCount;
+        offset = align(offset + mesh.meshletCount * sizeof(Meshlet));
+        entry.lodOffset = offset;
+        entry.lodCount = mesh.lodCount;
+        offset = align(offset + mesh.lodCount * sizeof(MeshLod));
+        memcpy(entry.boundsMin, mesh.boundsMin, sizeof(entry.boundsMin));
+        memcpy(entry.boundsMax, mesh.boundsMax, sizeof(entry.boundsMax));
+        entry.boundingRadius = mesh.boundingRadius;
+        entry.materialId = mesh.materialId;
+        entry.indexSize = mesh.indexSize;
+    }
+
+    // written aside and renamed, so that a reader never maps a partially written cache
+    auto temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        const char padding[gc_meshCacheAlignment]{};
+        auto write = [&file, &padding](const void *data, uint64_t size)
+        {
+            file.write(static_cast<const char *>(data), (std::streamsize)size);
+            auto paddingSize = align(file.tellp()) - (uint64_t)file.tellp();
+            file.write(padding, (std::streamsize)paddingSize);
+        };
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        write(entries.data(), sizeof(MeshCacheEntry) * entries.size());
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            write(meshes[i].vertices, meshes[i].vertexCount * key.vertexStride);
+            write(meshes[i].indices, meshes[i].indexCount * meshes[i].indexSize);
+            write(meshes[i].indexRanges, meshes[i].indexRangeCount * sizeof(IndexRange));
+            write(meshes[i].meshlets, meshes[i].meshletCount * sizeof(Meshlet));
+            write(meshes[i].lods, meshes[i].lodCount * sizeof(MeshLod));
+        }
+
+        if (!file.good())
+        {
+            file.close();
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(path.c_str());
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool readMeshCache(const vkfw::MappedFile &file, const MeshCacheKey &key, std::vector<MeshCacheMesh> &meshes)
+{
+    meshes.clear();
+    if (file.getSize() < sizeof(MeshCacheHeader))
+    {
+        return false;
+    }
+
+    MeshCacheHeader header;
+    memcpy(&header, file.getData(), sizeof(header));
+    if (memcmp(header.magic, gc_meshCacheMagic, sizeof(header.magic)) != 0 ||
+        header.version != gc_meshCacheVersion ||
+        header.key.sourceHash != key.sourceHash ||
+        header.key.sourceSize != key.sourceSize ||
+        header.key.options != key.options ||
+        header.key.vertexStride != key.vertexStride)
+    {
+        return false;
+    }
+
+    if (file.getSize() < sizeof(MeshCacheHeader) + sizeof(MeshCacheEntry) * (uint64_t)header.meshCount)
+    {
+        return false;
+    }
+    auto *entries = reinterpret_cast<const MeshCacheEntry *>(file.getData() + sizeof(MeshCacheHeader));
+
+    meshes.resize(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; ++i)
+    {
+        const auto &entry = entries[i];
+        // never trust offsets and counts to be within the file, nor indices to be within the mesh (every draw goes through an index range or a meshlet)
+        if ((entry.indexSize != sizeof(uint16_t) && entry.indexSize != sizeof(uint32_t)) ||
+            entry.vertexOffset > file.getSize() || entry.vertexCount > (file.getSize() - entry.vertexOffset) / key.vertexStride ||
+            entry.indexOffset > file.getSize() || entry.indexCount > (file.getSize() - entry.indexOffset) / entry.indexSize ||
+            entry.indexRangeOffset > file.getSize() || entry.indexRangeCount > (file.getSize() - entry.indexRangeOffset) / sizeof(IndexRange) ||
+            entry.meshletOffset > file.getSize() || entry.meshletCount > (file.getSize() - entry.meshletOffset) / sizeof(Meshlet) ||
+            entry.lodOffset > file.getSize() || entry.lodCount == 0 || entry.lodCount > (file.getSize() - entry.lodOffset) / sizeof(MeshLod) ||
+            entry.vertexOffset % gc_meshCacheAlignment != 0 || entry.indexOffset % gc_meshCacheAlignment != 0 || entry.indexRangeOffset % gc_meshCacheAlignment != 0 ||
+            entry.meshletOffset % gc_meshCacheAlignment != 0 || entry.lodOffset % gc_meshCacheAlignment != 0)
+        {
+            meshes.clear();
+            return false;
+        }
+
+        auto &mesh = meshes[i];
+        mesh.vertices = file.getData() + entry.vertexOffset;
+        mesh.vertexCount = entry.vertexCount;
+        mesh.indices = file.getData() + entry.indexOffset;
+        mesh.indexCount = entry.indexCount;
+        mesh.indexSize = entry.indexSize;
+        mesh.indexRanges = reinterpret_cast<const IndexRange *>(file.getData() + entry.indexRangeOffset);
+        mesh.indexRangeCount = entry.indexRangeCount;
+        for (uint64_t j = 0; j < mesh.indexRangeCount; ++j)
+        {
+            const auto &indexRange = mesh.indexRanges[j];
+            if ((uint64_t)indexRange.firstIndex + indexRange.indexCount > mesh.indexCount ||
+                !areIndicesInRange(mesh, indexRange.firstIndex, indexRange.indexCount, indexRange.baseVertex))
+            {
+                meshes.clear();
+                return false;
+            }
+        }
+        mesh.meshlets = reinterpret_cast<const Meshlet *>(file.getData() + entry.meshletOffset);
+        mesh.meshletCount = entry.meshletCount;
+        for (uint64_t j = 0; j < mesh.meshletCount; ++j)
+        {
+            const auto &meshlet = mesh.meshlets[j];
+            if ((uint64_t)meshlet.firstIndex + meshlet.indexCount > mesh.indexCount ||
+                !areIndicesInRange(mesh, meshlet.firstIndex, meshlet.indexCount, meshlet.baseVertex))
+            {
+                meshes.clear();
+                return false;
+            }
+        }
+        mesh.lods = reinterpret_cast<const MeshLod *>(file.getData() + entry.lodOffset);
+        mesh.lodCount = entry.lodCount;
+        for (uint64_t j = 0; j < mesh.lodCount; ++j)
+        {
+            const auto &lod = mesh.lods[j];
+            if ((uint64_t)lod.firstIndex + lod.indexCount > mesh.indexCount ||
+                (uint64_t)lod.firstIndexRange + lod.indexRangeCount > mesh.indexRangeCount ||
+                (uint64_t)lod.firstMeshlet + lod.meshletCount > mesh.meshletCount)
+            {
+                meshes.clear();
+                return false;
+            }
+        }
+        memcpy(mesh.boundsMin, entry.boundsMin, sizeof(mesh.boundsMin));
+        memcpy(mesh.boundsMax, entry.boundsMax, sizeof(mesh.boundsMax));
+        mesh.boundingRadius = entry.boundingRadius;
+        mesh.materialId = entry.materialId;
+    }
+    return true;
+}
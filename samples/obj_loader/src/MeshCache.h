@@ -0,0 +1,56 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlets.h"
+
+#include <vkfw/MappedFile.h>
+#include <vkfw/ThreadPool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// identifies what a mesh cache was built from, any mismatch invalidates it
+struct MeshCacheKey
+{
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    // bitmask of whatever loader steps change the cached vertices/indices
+    uint32_t options;
+    uint32_t vertexStride;
+};
+
+struct MeshCacheMesh
+{
+    const void *vertices;
+    uint64_t vertexCount;
+    const void *indices;
+    uint64_t indexCount;
+    // 2 or 4 bytes
+    uint32_t indexSize;
+    const IndexRange *indexRanges;
+    uint64_t indexRangeCount;
+    const Meshlet *meshlets;
+    uint64_t meshletCount;
+    // at least the full resolution one
+    const MeshLod *lods;
+    uint64_t lodCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    // bounding sphere around the center of the bounds
+    float boundingRadius;
+    // -1 if the mesh has no material
+    int32_t materialId;
+};
+
+// hashes the source in parallel blocks (so that a cache hit doesn't cost as much as a parse)
+uint64_t hashMeshCacheSource(const char *data, size_t size, vkfw::ThreadPool &threadPool);
+// the file is versioned and holds every mesh's vertices and indices in the layout they're uploaded in
+bool writeMeshCache(const std::string &path, const MeshCacheKey &key, const std::vector<MeshCacheMesh> &meshes);
+// no parsing, meshes point straight into the mapped file
+bool readMeshCache(const vkfw::MappedFile &file, const MeshCacheKey &key, std::vector<MeshCacheMesh> &meshes);
+
+#endif
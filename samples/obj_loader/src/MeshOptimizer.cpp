@@ -0,0 +1,628 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    // the simulated LRU cache the scores are based on
+    constexpr uint32_t gc_scoringCacheSize = 32;
+    constexpr float gc_cacheDecayPower = 1.5f;
+    constexpr float gc_lastTriangleScore = 0.75f;
+    constexpr float gc_valenceBoostScale = 2.0f;
+    constexpr float gc_valenceBoostPower = 0.5f;
+    // cache the clusters are built for
+    constexpr uint32_t gc_clusterCacheSize = 16;
+    constexpr uint32_t gc_overdrawViewportSize = 256;
+    // 16KB
+    constexpr size_t gc_fetchCacheLineSize = 64;
+    constexpr size_t gc_fetchCacheLineCount = 256;
+    constexpr uint32_t gc_unusedVertex = ~0u;
+
+    float computeVertexScore(int32_t cachePosition, uint32_t remainingValence)
+    {
+        // the vertex doesn't matter anymore
+        if (remainingValence == 0)
+        {
+            return -1;
+        }
+
+        float score = 0;
+        if (cachePosition >= 0)
+        {
+            // the last triangle's vertices get a fixed score, so that the next triangle doesn't just reuse its most recent edge
+            if (cachePosition < 3)
+            {
+                score = gc_lastTriangleScore;
+            }
+            else
+            {
+                score = powf(1 - (cachePosition - 3) / (float)(gc_scoringCacheSize - 3), gc_cacheDecayPower);
+            }
+        }
+
+        // vertices with few triangles left get priority, so that they don't linger as lone triangles
+        return score + gc_valenceBoostScale * powf((float)remainingValence, -gc_valenceBoostPower);
+    }
+
+
+    inline const float *getPosition(const float *positions, size_t vertexStride, uint32_t index)
+    {
+        return reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + vertexStride * index);
+    }
+
+    // transformed vertices, with a FIFO cache whose contents are invalidated by advancing time past cacheSize
+    inline uint32_t transformTriangle(const uint32_t *triangle, std::vector<size_t> &transformTimes, size_t &time, uint32_t cacheSize)
+    {
+        uint32_t misses = 0;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            if (time - transformTimes[triangle[i]] > cacheSize)
+            {
+                transformTimes[triangle[i]] = time++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    // triangles whose vertices all miss the cache usually start a new patch of the mesh
+    std::vector<size_t> findHardBoundaries(const uint32_t *indices, size_t triangleCount, size_t vertexCount)
+    {
+        std::vector<size_t> transformTimes(vertexCount, 0);
+        size_t time = gc_clusterCacheSize + 1;
+        std::vector<size_t> boundaries;
+        for (size_t i = 0; i < triangleCount; ++i)
+        {
+            if (transformTriangle(&indices[i * 3], transformTimes, time, gc_clusterCacheSize) == 3 || i == 0)
+            {
+                boundaries.emplace_back(i);
+            }
+        }
+        return boundaries;
+    }
+
+    // splits every patch wherever the running ACMR (with a cold cache) gets within threshold times the patch's own ACMR
+    std::vector<size_t> findSoftBoundaries(const uint32_t *indices, size_t triangleCount, size_t vertexCount, const std::vector<size_t> &hardBoundaries, float threshold)
+    {
+        std::vector<size_t> transformTimes(vertexCount, 0);
+        size_t time = 0;
+        std::vector<size_t> boundaries;
+        for (size_t i = 0; i < hardBoundaries.size(); ++i)
+        {
+            auto begin = hardBoundaries[i];
+            auto end = i + 1 < hardBoundaries.size() ? hardBoundaries[i + 1] : triangleCount;
+
+            time += gc_clusterCacheSize + 1;
+            size_t misses = 0;
+            for (auto j = begin; j < end; ++j)
+            {
+                misses += transformTriangle(&indices[j * 3], transformTimes, time, gc_clusterCacheSize);
+            }
+            auto clusterThreshold = threshold * misses / (float)(end - begin);
+
+            boundaries.emplace_back(begin);
+            time += gc_clusterCacheSize + 1;
+            size_t runningMisses = 0, runningTriangleCount = 0;
+            for (auto j = begin; j < end; ++j)
+            {
+                runningMisses += transformTriangle(&indices[j * 3], transformTimes, time, gc_clusterCacheSize);
+                ++runningTriangleCount;
+                if (runningMisses <= clusterThreshold * runningTriangleCount)
+                {
+                    boundaries.emplace_back(j + 1);
+                    time += gc_clusterCacheSize + 1;
+                    runningMisses = 0;
+                    runningTriangleCount = 0;
+                }
+            }
+
+            // the last cluster is whatever is left, usually a few triangles with a bad ACMR, so it's merged into the previous one
+            // (which also drops the boundary at end, if the last cluster happened to close right there)
+            if (boundaries.back() != begin)
+            {
+                boundaries.pop_back();
+            }
+        }
+        return boundaries;
+    }
+
+    void rasterize(const float a[3], const float b[3], const float c[3], std::vector<float> &depthBuffer, OverdrawStatistics &statistics)
+    {
+        // counter-clockwise triangles (obj's front faces) have a positive area, the others are culled
+        auto area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        if (area <= 0)
+        {
+            return;
+        }
+
+        auto minX = std::max((int32_t)floorf(std::min({a[0], b[0], c[0]})), 0);
+        auto minY = std::max((int32_t)floorf(std::min({a[1], b[1], c[1]})), 0);
+        auto maxX = std::min((int32_t)ceilf(std::max({a[0], b[0], c[0]})), (int32_t)gc_overdrawViewportSize - 1);
+        auto maxY = std::min((int32_t)ceilf(std::max({a[1], b[1], c[1]})), (int32_t)gc_overdrawViewportSize - 1);
+
+        for (auto y = minY; y <= maxY; ++y)
+        {
+            for (auto x = minX; x <= maxX; ++x)
+            {
+                // barycentrics at the pixel center
+                auto px = x + 0.5f, py = y + 0.5f;
+                auto w0 = (c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]);
+                auto w1 = (a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]);
+                auto w2 = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+                if (w0 < 0 || w1 < 0 || w2 < 0)
+                {
+                    continue;
+                }
+
+                auto depth = (w0 * a[2] + w1 * b[2] + w2 * c[2]) / area;
+                auto &storedDepth = depthBuffer[y * gc_overdrawViewportSize + x];
+                if (depth < storedDepth)
+                {
+                    if (storedDepth == FLT_MAX)
+                    {
+                        ++statistics.coveredPixelCount;
+                    }
+                    storedDepth = depth;
+                    ++statistics.shadedPixelCount;
+                }
+            }
+        }
+    }
+
+}
+
+VertexCacheStatistics &VertexCacheStatistics::operator+=(const VertexCacheStatistics &other)
+{
+    transformedVertexCount += other.transformedVertexCount;
+    triangleCount += other.triangleCount;
+    vertexCount += other.vertexCount;
+    return *this;
+}
+
+VertexCacheStatistics analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+    VertexCacheStatistics statistics;
+    statistics.triangleCount = indexCount / 3;
+
+    // a vertex is in the cache if less than cacheSize vertices were transformed since it was
+    std::vector<size_t> transformTimes(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t time = cacheSize + 1;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        auto index = indices[i];
+        if (time - transformTimes[index] > cacheSize)
+        {
+            transformTimes[index] = time++;
+            ++statistics.transformedVertexCount;
+        }
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            ++statistics.vertexCount;
+        }
+    }
+    return statistics;
+}
+
+void optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount)
+{
+    auto triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // triangles adjacent to every vertex. the first remainingValence entries of a vertex's range are the ones not emitted yet
+    std::vector<uint32_t> remainingValences(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        ++remainingValences[indices[i]];
+    }
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingValences[i];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> adjacencyCursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+        {
+            adjacency[adjacencyCursors[indices[i]]++] = (uint32_t)(i / 3);
+        }
+    }
+
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        vertexScores[i] = computeVertexScore(-1, remainingValences[i]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    size_t bestTriangle = 0;
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+        if (triangleScores[i] > triangleScores[bestTriangle])
+        {
+            bestTriangle = i;
+        }
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> optimizedIndices(triangleCount * 3);
+    uint32_t cache[gc_scoringCacheSize + 3];
+    uint32_t newCache[gc_scoringCacheSize + 3];
+    uint32_t cacheSize = 0;
+    // for when the cache has no triangles left to offer
+    size_t nextUnemittedTriangle = 0;
+
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        if (bestTriangle == triangleCount)
+        {
+            while (emitted[nextUnemittedTriangle])
+            {
+                ++nextUnemittedTriangle;
+            }
+            bestTriangle = nextUnemittedTriangle;
+        }
+
+        const auto *triangle = &indices[bestTriangle * 3];
+        emitted[bestTriangle] = true;
+
+        uint32_t newCacheSize = 0;
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            auto vertex = triangle[j];
+            optimizedIndices[i * 3 + j] = vertex;
+            // degenerate triangles repeat vertices
+            if (std::find(newCache, newCache + newCacheSize, vertex) == newCache + newCacheSize)
+            {
+                newCache[newCacheSize++] = vertex;
+            }
+
+            // swap-remove the triangle from the vertex's remaining ones
+            auto *vertexAdjacency = &adjacency[adjacencyOffsets[vertex]];
+            auto remainingValence = remainingValences[vertex];
+            for (uint32_t k = 0; k < remainingValence; ++k)
+            {
+                if (vertexAdjacency[k] == bestTriangle)
+                {
+                    std::swap(vertexAdjacency[k], vertexAdjacency[remainingValence - 1]);
+                    break;
+                }
+            }
+            --remainingValences[vertex];
+        }
+
+        for (uint32_t j = 0; j < cacheSize; ++j)
+        {
+            auto vertex = cache[j];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+            {
+                newCache[newCacheSize++] = vertex;
+            }
+        }
+
+        // vertices pushed out of the cache
+        for (uint32_t j = gc_scoringCacheSize; j < newCacheSize; ++j)
+        {
+            auto vertex = newCache[j];
+            auto score = computeVertexScore(-1, remainingValences[vertex]);
+            auto delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+            for (uint32_t k = 0; k < remainingValences[vertex]; ++k)
+            {
+                triangleScores[adjacency[adjacencyOffsets[vertex] + k]] += delta;
+            }
+        }
+
+        cacheSize = std::min(newCacheSize, gc_scoringCacheSize);
+        std::copy(newCache, newCache + cacheSize, cache);
+
+        for (uint32_t j = 0; j < cacheSize; ++j)
+        {
+            auto vertex = cache[j];
+            auto score = computeVertexScore((int32_t)j, remainingValences[vertex]);
+            auto delta = score - vertexScores[vertex];
+            vertexScores[vertex] = score;
+            for (uint32_t k = 0; k < remainingValences[vertex]; ++k)
+            {
+                triangleScores[adjacency[adjacencyOffsets[vertex] + k]] += delta;
+            }
+        }
+
+        // only triangles touching the cache are candidates
+        bestTriangle = triangleCount;
+        float bestScore = -1;
+        for (uint32_t j = 0; j < cacheSize; ++j)
+        {
+            auto vertex = cache[j];
+            for (uint32_t k = 0; k < remainingValences[vertex]; ++k)
+            {
+                auto candidate = adjacency[adjacencyOffsets[vertex] + k];
+                if (triangleScores[candidate] > bestScore)
+                {
+                    bestScore = triangleScores[candidate];
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    std::copy(optimizedIndices.begin(), optimizedIndices.end(), indices);
+}
+
+OverdrawStatistics &OverdrawStatistics::operator+=(const OverdrawStatistics &other)
+{
+    coveredPixelCount += other.coveredPixelCount;
+    shadedPixelCount += other.shadedPixelCount;
+    return *this;
+}
+
+OverdrawStatistics analyzeOverdraw(const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride)
+{
+    OverdrawStatistics statistics;
+    if (vertexCount == 0)
+    {
+        return statistics;
+    }
+
+    float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const auto *position = getPosition(positions, vertexStride, i);
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            boundsMin[j] = std::min(boundsMin[j], position[j]);
+            boundsMax[j] = std::max(boundsMax[j], position[j]);
+        }
+    }
+    auto extent = std::max({boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2], FLT_MIN});
+    auto scale = (gc_overdrawViewportSize - 1) / extent;
+
+    std::vector<float> depthBuffer(gc_overdrawViewportSize * gc_overdrawViewportSize);
+    std::vector<float> projectedPositions(vertexCount * 3);
+    for (uint32_t axis = 0; axis < 3; ++axis)
+    {
+        // x and y are the other two axes (in an order that keeps the basis right-handed), depth grows away from the viewer
+        auto xAxis = (axis + 1) % 3, yAxis = (axis + 2) % 3;
+        for (int32_t direction = -1; direction <= 1; direction += 2)
+        {
+            for (uint32_t i = 0; i < vertexCount; ++i)
+            {
+                const auto *position = getPosition(positions, vertexStride, i);
+                auto *projectedPosition = &projectedPositions[i * 3];
+                // looking down -axis mirrors x, so that front faces stay counter-clockwise
+                projectedPosition[0] = (direction > 0 ? position[xAxis] - boundsMin[xAxis] : boundsMax[xAxis] - position[xAxis]) * scale;
+                projectedPosition[1] = (position[yAxis] - boundsMin[yAxis]) * scale;
+                projectedPosition[2] = direction > 0 ? boundsMax[axis] - position[axis] : position[axis] - boundsMin[axis];
+            }
+
+            std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+            for (size_t i = 0; i + 2 < indexCount; i += 3)
+            {
+                rasterize(&projectedPositions[indices[i] * 3], &projectedPositions[indices[i + 1] * 3], &projectedPositions[indices[i + 2] * 3], depthBuffer, statistics);
+            }
+        }
+    }
+    return statistics;
+}
+
+void optimizeOverdraw(uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride, float threshold)
+{
+    auto triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    auto clusterBoundaries = findSoftBoundaries(indices, triangleCount, vertexCount, findHardBoundaries(indices, triangleCount, vertexCount), threshold);
+    auto clusterCount = clusterBoundaries.size();
+
+    // area-weighted centroids and normals
+    std::vector<float> clusterCentroids(clusterCount * 3, 0);
+    std::vector<float> clusterNormals(clusterCount * 3, 0);
+    float meshCentroid[3] = {0, 0, 0};
+    float meshArea = 0;
+    for (size_t i = 0; i < clusterCount; ++i)
+    {
+        auto begin = clusterBoundaries[i];
+        auto end = i + 1 < clusterCount ? clusterBoundaries[i + 1] : triangleCount;
+        auto *centroid = &clusterCentroids[i * 3];
+        auto *normal = &clusterNormals[i * 3];
+        float clusterArea = 0;
+        for (auto j = begin; j < end; ++j)
+        {
+            const auto *a = getPosition(positions, vertexStride, indices[j * 3]);
+            const auto *b = getPosition(positions, vertexStride, indices[j * 3 + 1]);
+            const auto *c = getPosition(positions, vertexStride, indices[j * 3 + 2]);
+
+            float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            float triangleNormal[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+            // twice the area
+            auto area = sqrtf(triangleNormal[0] * triangleNormal[0] + triangleNormal[1] * triangleNormal[1] + triangleNormal[2] * triangleNormal[2]);
+
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                centroid[k] += (a[k] + b[k] + c[k]) / 3 * area;
+                normal[k] += triangleNormal[k];
+            }
+            clusterArea += area;
+        }
+
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            meshCentroid[k] += centroid[k];
+            centroid[k] = clusterArea > 0 ? centroid[k] / clusterArea : 0;
+        }
+        meshArea += clusterArea;
+
+        auto normalLength = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            normal[k] = normalLength > 0 ? normal[k] / normalLength : 0;
+        }
+    }
+    for (uint32_t k = 0; k < 3; ++k)
+    {
+        meshCentroid[k] = meshArea > 0 ? meshCentroid[k] / meshArea : 0;
+    }
+
+    // clusters far out from the center and facing outwards occlude the most, so they go first
+    std::vector<float> occlusionPotentials(clusterCount);
+    for (size_t i = 0; i < clusterCount; ++i)
+    {
+        const auto *centroid = &clusterCentroids[i * 3];
+        const auto *normal = &clusterNormals[i * 3];
+        occlusionPotentials[i] = (centroid[0] - meshCentroid[0]) * normal[0] + (centroid[1] - meshCentroid[1]) * normal[1] + (centroid[2] - meshCentroid[2]) * normal[2];
+    }
+
+    std::vector<size_t> clusterOrder(clusterCount);
+    for (size_t i = 0; i < clusterCount; ++i)
+    {
+        clusterOrder[i] = i;
+    }
+    std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&occlusionPotentials](size_t a, size_t b)
+                     { return occlusionPotentials[a] > occlusionPotentials[b]; });
+
+    std::vector<uint32_t> sortedIndices;
+    sortedIndices.reserve(triangleCount * 3);
+    for (auto cluster : clusterOrder)
+    {
+        auto begin = clusterBoundaries[cluster];
+        auto end = cluster + 1 < clusterCount ? clusterBoundaries[cluster + 1] : triangleCount;
+        sortedIndices.insert(sortedIndices.end(), indices + begin * 3, indices + end * 3);
+    }
+    std::copy(sortedIndices.begin(), sortedIndices.end(), indices);
+}
+
+VertexFetchStatistics &VertexFetchStatistics::operator+=(const VertexFetchStatistics &other)
+{
+    fetchedByteCount += other.fetchedByteCount;
+    vertexBufferSize += other.vertexBufferSize;
+    return *this;
+}
+
+VertexFetchStatistics analyzeVertexFetch(const uint32_t *indices, size_t indexCount, size_t vertexCount, size_t vertexStride)
+{
+    VertexFetchStatistics statistics;
+
+    std::vector<bool> referenced(vertexCount, false);
+    std::vector<size_t> cacheTags(gc_fetchCacheLineCount, ~(size_t)0);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        auto index = indices[i];
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            statistics.vertexBufferSize += vertexStride;
+        }
+
+        // a vertex can straddle cache lines
+        auto firstLine = index * vertexStride / gc_fetchCacheLineSize;
+        auto lastLine = ((index + 1) * vertexStride - 1) / gc_fetchCacheLineSize;
+        for (auto line = firstLine; line <= lastLine; ++line)
+        {
+            auto &tag = cacheTags[line % gc_fetchCacheLineCount];
+            if (tag != line)
+            {
+                tag = line;
+                statistics.fetchedByteCount += gc_fetchCacheLineSize;
+            }
+        }
+    }
+    return statistics;
+}
+
+size_t buildVertexFetchRemap(uint32_t *remap, const uint32_t *indices, size_t indexCount, size_t vertexCount)
+{
+    std::fill(remap, remap + vertexCount, gc_unusedVertex);
+    uint32_t usedVertexCount = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        auto &newIndex = remap[indices[i]];
+        if (newIndex == gc_unusedVertex)
+        {
+            newIndex = usedVertexCount++;
+        }
+    }
+    return usedVertexCount;
+}
+
+void remapIndices(uint32_t *indices, size_t indexCount, const uint32_t *remap)
+{
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        indices[i] = remap[indices[i]];
+    }
+}
+
+void remapVertices(void *destination, const void *vertices, size_t vertexCount, size_t vertexStride, const uint32_t *remap)
+{
+    auto *destinationBytes = static_cast<char *>(destination);
+    const auto *vertexBytes = static_cast<const char *>(vertices);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        if (remap[i] != gc_unusedVertex)
+        {
+            memcpy(destinationBytes + remap[i] * vertexStride, vertexBytes + i * vertexStride, vertexStride);
+        }
+    }
+}
+
+std::vector<IndexRange> splitIndexRanges(const uint32_t *indices, size_t indexCount, uint32_t maxVertexSpan)
+{
+    std::vector<IndexRange> ranges;
+    if (indexCount == 0)
+    {
+        return ranges;
+    }
+
+    IndexRange range{0, 0, 0};
+    auto minVertex = ~0u, maxVertex = 0u;
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        auto triangleMin = std::min({indices[i], indices[i + 1], indices[i + 2]});
+        auto triangleMax = std::max({indices[i], indices[i + 1], indices[i + 2]});
+        if (triangleMax - triangleMin >= maxVertexSpan)
+        {
+            return {};
+        }
+
+        if (range.indexCount > 0 && std::max(maxVertex, triangleMax) - std::min(minVertex, triangleMin) >= maxVertexSpan)
+        {
+            range.baseVertex = minVertex;
+            ranges.emplace_back(range);
+            range = {(uint32_t)i, 0, 0};
+            minVertex = ~0u;
+            maxVertex = 0;
+        }
+
+        minVertex = std::min(minVertex, triangleMin);
+        maxVertex = std::max(maxVertex, triangleMax);
+        range.indexCount += 3;
+    }
+    range.baseVertex = minVertex;
+    ranges.emplace_back(range);
+    return ranges;
+}
+
+void compactIndices(uint16_t *destination, const uint32_t *indices, const std::vector<IndexRange> &ranges)
+{
+    for (const auto &range : ranges)
+    {
+        for (auto i = range.firstIndex; i < range.firstIndex + range.indexCount; ++i)
+        {
+            destination[i] = (uint16_t)(indices[i] - range.baseVertex);
+        }
+    }
+}
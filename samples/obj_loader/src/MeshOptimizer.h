@@ -0,0 +1,99 @@
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// drawn with vkCmdDrawIndexed(indexCount, 1, firstIndex, baseVertex, 0)
+struct IndexRange
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t baseVertex;
+};
+
+// totals, so that statistics of several meshes can be accumulated
+struct VertexCacheStatistics
+{
+    size_t transformedVertexCount{0};
+    size_t triangleCount{0};
+    size_t vertexCount{0};
+
+    // average cache miss ratio (transformed vertices per triangle), 0.5 at best
+    inline float getAcmr() const
+    {
+        return triangleCount > 0 ? transformedVertexCount / (float)triangleCount : 0;
+    }
+
+    // average transform to vertex ratio, 1 at best
+    inline float getAtvr() const
+    {
+        return vertexCount > 0 ? transformedVertexCount / (float)vertexCount : 0;
+    }
+
+    VertexCacheStatistics &operator+=(const VertexCacheStatistics &other);
+};
+
+struct OverdrawStatistics
+{
+    size_t coveredPixelCount{0};
+    size_t shadedPixelCount{0};
+
+    // shaded fragments per covered pixel, 1 at best
+    inline float getOverdraw() const
+    {
+        return coveredPixelCount > 0 ? shadedPixelCount / (float)coveredPixelCount : 0;
+    }
+
+    OverdrawStatistics &operator+=(const OverdrawStatistics &other);
+};
+
+struct VertexFetchStatistics
+{
+    size_t fetchedByteCount{0};
+    size_t vertexBufferSize{0};
+
+    // bytes fetched per byte of referenced vertices, 1 at best
+    inline float getOverfetch() const
+    {
+        return vertexBufferSize > 0 ? fetchedByteCount / (float)vertexBufferSize : 0;
+    }
+
+    VertexFetchStatistics &operator+=(const VertexFetchStatistics &other);
+};
+
+// simulates a FIFO post-transform vertex cache with cacheSize entries
+VertexCacheStatistics analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+// reorders triangles in place for post-transform vertex cache locality (Forsyth's linear-speed vertex cache optimization).
+// vertices are left untouched
+void optimizeVertexCache(uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+// positions are 3 floats, vertexStride bytes apart.
+// rasterizes the mesh (back faces culled, depth tested) from the 6 axis-aligned directions into a small software depth buffer
+OverdrawStatistics analyzeOverdraw(const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride);
+
+// reorders vertex cache optimized triangles in place, so that the ones likely to occlude others are drawn first (Sander et al.'s "fast triangle reordering").
+// triangles are split into clusters wherever the cluster's ACMR is within threshold times the original one (ie.: 1.05 allows 5% more cache misses),
+// and clusters are sorted by how much they face away from the mesh center (view-independent occlusion potential)
+void optimizeOverdraw(uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride, float threshold);
+
+// simulates a small direct-mapped cache of 64-byte lines in front of a vertex buffer with vertexStride bytes per vertex
+VertexFetchStatistics analyzeVertexFetch(const uint32_t *indices, size_t indexCount, size_t vertexCount, size_t vertexStride);
+
+// fills remap (vertexCount entries) with the new index of every vertex, in order of first use by the indices (unused vertices map to ~0u).
+// returns the number of used vertices
+size_t buildVertexFetchRemap(uint32_t *remap, const uint32_t *indices, size_t indexCount, size_t vertexCount);
+void remapIndices(uint32_t *indices, size_t indexCount, const uint32_t *remap);
+// call once per stream for split vertex streams. destination has room for the used vertices only
+void remapVertices(void *destination, const void *vertices, size_t vertexCount, size_t vertexStride, const uint32_t *remap);
+
+// splits the triangles into consecutive ranges whose vertices all lie within maxVertexSpan vertices from the range's base vertex
+// (so that they can be indexed relative to it with fewer bits). works best after remapping vertices in fetch order.
+// returns no ranges if a single triangle already spans too many vertices
+std::vector<IndexRange> splitIndexRanges(const uint32_t *indices, size_t indexCount, uint32_t maxVertexSpan);
+// the indices of every range relative to its base vertex
+void compactIndices(uint16_t *destination, const uint32_t *indices, const std::vector<IndexRange> &ranges);
+
+#endif
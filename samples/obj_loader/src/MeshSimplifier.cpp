@@ -0,0 +1,293 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t gc_noVertex = ~0u;
+
+    // symmetric 4x4 matrix of the squared distances to a set of planes, weighted by their triangle areas
+    struct Quadric
+    {
+        double a00, a11, a22, a01, a02, a12;
+        double b0, b1, b2;
+        double c;
+        double weight;
+
+        Quadric &operator+=(const Quadric &other)
+        {
+            a00 += other.a00;
+            a11 += other.a11;
+            a22 += other.a22;
+            a01 += other.a01;
+            a02 += other.a02;
+            a12 += other.a12;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        double evaluate(const float *p) const
+        {
+            double x = p[0], y = p[1], z = p[2];
+            return a00 * x * x + a11 * y * y + a22 * z * z + 2 * (a01 * x * y + a02 * x * z + a12 * y * z) + 2 * (b0 * x + b1 * y + b2 * z) + c;
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        float error;
+    };
+
+    inline const float *getPosition(const float *positions, size_t vertexStride, uint32_t index)
+    {
+        return reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + index * vertexStride);
+    }
+
+    inline void computeNormal(const float *a, const float *b, const float *c, float normal[3])
+    {
+        float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+        normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+        normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+    }
+
+    inline uint64_t getEdgeKey(uint32_t a, uint32_t b)
+    {
+        return ((uint64_t)a << 32) | b;
+    }
+
+    std::vector<Quadric> computeQuadrics(const std::vector<uint32_t> &indices, const float *positions, size_t vertexCount, size_t vertexStride)
+    {
+        std::vector<Quadric> quadrics(vertexCount, Quadric{});
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            const float *p[3];
+            for (size_t j = 0; j < 3; ++j)
+            {
+                p[j] = getPosition(positions, vertexStride, indices[i + j]);
+            }
+            float normal[3];
+            computeNormal(p[0], p[1], p[2], normal);
+            double length = std::sqrt((double)normal[0] * normal[0] + (double)normal[1] * normal[1] + (double)normal[2] * normal[2]);
+            if (length == 0)
+            {
+                continue;
+            }
+            double n[3] = {normal[0] / length, normal[1] / length, normal[2] / length};
+            double d = -(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]);
+            double area = length * 0.5;
+
+            Quadric quadric{n[0] * n[0] * area, n[1] * n[1] * area, n[2] * n[2] * area, n[0] * n[1] * area, n[0] * n[2] * area, n[1] * n[2] * area,
+                            n[0] * d * area, n[1] * d * area, n[2] * d * area, d * d * area, area};
+            for (size_t j = 0; j < 3; ++j)
+            {
+                quadrics[indices[i + j]] += quadric;
+            }
+        }
+        return quadrics;
+    }
+
+    // vertices on an edge used by a single triangle (ie.: open borders, or attribute seams, where neighbouring triangles index different vertices)
+    std::vector<bool> findBorderVertices(const std::vector<uint32_t> &indices, size_t vertexCount)
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                edges.emplace_back(getEdgeKey(indices[i + j], indices[i + (j + 1) % 3]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<bool> borderVertices(vertexCount, false);
+        for (auto edge : edges)
+        {
+            auto a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+            if (!std::binary_search(edges.begin(), edges.end(), getEdgeKey(b, a)))
+            {
+                borderVertices[a] = true;
+                borderVertices[b] = true;
+            }
+        }
+        return borderVertices;
+    }
+
+    // triangles (first index of) around every vertex
+    void buildAdjacency(const std::vector<uint32_t> &indices, size_t vertexCount, std::vector<uint32_t> &offsets, std::vector<uint32_t> &triangles)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        for (auto index : indices)
+        {
+            ++offsets[index + 1];
+        }
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            offsets[i + 1] += offsets[i];
+        }
+        triangles.resize(indices.size());
+        std::vector<uint32_t> counts(vertexCount, 0);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            triangles[offsets[indices[i]] + counts[indices[i]]++] = (uint32_t)(i - i % 3);
+        }
+    }
+
+    // whether collapsing from onto to would turn any of the remaining triangles around from upside down
+    bool flipsTriangles(const std::vector<uint32_t> &indices, const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &triangles, const float *positions, size_t vertexStride, uint32_t from, uint32_t to)
+    {
+        auto *target = getPosition(positions, vertexStride, to);
+        for (auto i = offsets[from]; i < offsets[from + 1]; ++i)
+        {
+            auto triangle = triangles[i];
+            const float *p[3], *q[3];
+            bool collapsed = false;
+            for (size_t j = 0; j < 3; ++j)
+            {
+                auto index = indices[triangle + j];
+                collapsed |= index == to;
+                p[j] = getPosition(positions, vertexStride, index);
+                q[j] = index == from ? target : p[j];
+            }
+            // removed by the collapse
+            if (collapsed)
+            {
+                continue;
+            }
+            float before[3], after[3];
+            computeNormal(p[0], p[1], p[2], before);
+            computeNormal(q[0], q[1], q[2], after);
+            if (before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+size_t simplifyMesh(uint32_t *destination, const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride, size_t targetIndexCount, float maxError, float &error)
+{
+    std::vector<uint32_t> result(indices, indices + indexCount);
+    error = 0;
+
+    auto quadrics = computeQuadrics(result, positions, vertexCount, vertexStride);
+    auto borderVertices = findBorderVertices(result, vertexCount);
+
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> offsets, triangles;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    // every pass collapses the cheapest edges whose neighbourhoods don't overlap
+    while (result.size() > targetIndexCount)
+    {
+        edges.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                auto a = result[i + j], b = result[i + (j + 1) % 3];
+                edges.emplace_back(getEdgeKey(std::min(a, b), std::max(a, b)));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        collapses.clear();
+        for (auto edge : edges)
+        {
+            uint32_t vertices[2] = {(uint32_t)(edge >> 32), (uint32_t)edge};
+            Collapse collapse{gc_noVertex, gc_noVertex, 0};
+            for (size_t j = 0; j < 2; ++j)
+            {
+                auto from = vertices[j], to = vertices[1 - j];
+                if (borderVertices[from])
+                {
+                    continue;
+                }
+                auto quadric = quadrics[from];
+                quadric += quadrics[to];
+                auto collapseError = quadric.weight > 0 ? (float)std::sqrt(std::max(quadric.evaluate(getPosition(positions, vertexStride, to)), 0.0) / quadric.weight) : 0;
+                if (collapse.from == gc_noVertex || collapseError < collapse.error)
+                {
+                    collapse = {from, to, collapseError};
+                }
+            }
+            if (collapse.from != gc_noVertex && collapse.error <= maxError)
+            {
+                collapses.emplace_back(collapse);
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &a, const Collapse &b)
+                  { return a.error < b.error; });
+
+        buildAdjacency(result, vertexCount, offsets, triangles);
+        for (uint32_t i = 0; i < vertexCount; ++i)
+        {
+            remap[i] = i;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        // every collapse removes the triangles around its edge
+        auto removableTriangleCount = (result.size() - targetIndexCount + 2) / 3;
+        size_t removedTriangleCount = 0;
+        for (const auto &collapse : collapses)
+        {
+            if (removedTriangleCount >= removableTriangleCount)
+            {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to] || flipsTriangles(result, offsets, triangles, positions, vertexStride, collapse.from, collapse.to))
+            {
+                continue;
+            }
+
+            // the flip test assumes that the neighbourhood doesn't move
+            for (auto i = offsets[collapse.from]; i < offsets[collapse.from + 1]; ++i)
+            {
+                auto triangle = triangles[i];
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    touched[result[triangle + j]] = true;
+                    removedTriangleCount += result[triangle + j] == collapse.to;
+                }
+            }
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            error = std::max(error, collapse.error);
+        }
+        if (removedTriangleCount == 0)
+        {
+            break;
+        }
+
+        size_t resultIndexCount = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            auto a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+            if (a == b || b == c || c == a)
+            {
+                continue;
+            }
+            result[resultIndexCount++] = a;
+            result[resultIndexCount++] = b;
+            result[resultIndexCount++] = c;
+        }
+        result.resize(resultIndexCount);
+    }
+
+    std::copy(result.begin(), result.end(), destination);
+    return result.size();
+}
@@ -0,0 +1,27 @@
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// a level of detail of a mesh. all the lods of a mesh share its vertices, their indices, index ranges and meshlets are laid out one lod after the other
+struct MeshLod
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t firstIndexRange;
+    uint32_t indexRangeCount;
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+    // in object space, how far the lod can be from the full resolution mesh (0 for the full resolution mesh)
+    float error;
+};
+
+// quadric error metric edge collapses (Garland and Heckbert). vertices are collapsed onto one of their neighbours, so the simplified triangles
+// index the same vertices. vertices on borders (including attribute seams) never move and collapses that would flip triangles are rejected.
+// writes the simplified triangles to destination (room for indexCount indices, can be indices) and returns their index count, which
+// is only larger than targetIndexCount if maxError was hit. positions are 3 floats, vertexStride bytes apart.
+// error is set to the largest error of the collapses made (roughly the RMS distance to the input surface, in object space)
+size_t simplifyMesh(uint32_t *destination, const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t vertexStride, size_t targetIndexCount, float maxError, float &error);
+
+#endif
@@ -0,0 +1,141 @@
+#include "Meshlets.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // triangle normals further than ~84 degrees from the axis make the cone useless
+    constexpr float gc_minConeSpread = 0.1f;
+    constexpr uint32_t gc_noMeshlet = ~0u;
+
+    inline const float *getPosition(const float *positions, size_t vertexStride, uint32_t index)
+    {
+        return reinterpret_cast<const float *>(reinterpret_cast<const char *>(positions) + index * vertexStride);
+    }
+
+    void computeBounds(const uint32_t *indices, const float *positions, size_t vertexStride, Meshlet &meshlet)
+    {
+        float boundsMin[3], boundsMax[3];
+        auto *first = getPosition(positions, vertexStride, indices[meshlet.firstIndex]);
+        for (int k = 0; k < 3; ++k)
+        {
+            boundsMin[k] = boundsMax[k] = first[k];
+        }
+        for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; ++i)
+        {
+            auto *position = getPosition(positions, vertexStride, indices[i]);
+            for (int k = 0; k < 3; ++k)
+            {
+                boundsMin[k] = std::min(boundsMin[k], position[k]);
+                boundsMax[k] = std::max(boundsMax[k], position[k]);
+            }
+        }
+
+        // centered on the bounding box, not minimal but close enough for culling
+        for (int k = 0; k < 3; ++k)
+        {
+            meshlet.center[k] = (boundsMin[k] + boundsMax[k]) * 0.5f;
+        }
+        float radiusSquared = 0;
+        for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; ++i)
+        {
+            auto *position = getPosition(positions, vertexStride, indices[i]);
+            float d[3] = {position[0] - meshlet.center[0], position[1] - meshlet.center[1], position[2] - meshlet.center[2]};
+            radiusSquared = std::max(radiusSquared, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        // the axis is the average of the (counter-clockwise) triangle normals, the cutoff depends on the normal furthest from it
+        std::vector<float> normals;
+        normals.reserve(meshlet.indexCount);
+        float axis[3] = {0, 0, 0};
+        for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i += 3)
+        {
+            auto *a = getPosition(positions, vertexStride, indices[i]);
+            auto *b = getPosition(positions, vertexStride, indices[i + 1]);
+            auto *c = getPosition(positions, vertexStride, indices[i + 2]);
+            float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+            float normal[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+            auto length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            // degenerate triangles are never visible
+            if (length == 0)
+            {
+                continue;
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                normal[k] /= length;
+                axis[k] += normal[k];
+                normals.emplace_back(normal[k]);
+            }
+        }
+
+        auto axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        meshlet.coneCutoff = 1;
+        for (int k = 0; k < 3; ++k)
+        {
+            meshlet.coneAxis[k] = axisLength > 0 ? axis[k] / axisLength : 0;
+        }
+        if (axisLength == 0)
+        {
+            return;
+        }
+
+        float minDot = 1;
+        for (size_t i = 0; i < normals.size(); i += 3)
+        {
+            minDot = std::min(minDot, normals[i] * meshlet.coneAxis[0] + normals[i + 1] * meshlet.coneAxis[1] + normals[i + 2] * meshlet.coneAxis[2]);
+        }
+        if (minDot > gc_minConeSpread)
+        {
+            meshlet.coneCutoff = std::sqrt(1 - minDot * minDot);
+        }
+    }
+
+}
+
+std::vector<Meshlet> buildMeshlets(const uint32_t *indices, const std::vector<IndexRange> &ranges, const float *positions, size_t vertexCount, size_t vertexStride, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+{
+    std::vector<Meshlet> meshlets;
+    // the meshlet every vertex was last counted in
+    std::vector<uint32_t> vertexMeshlets(vertexCount, gc_noMeshlet);
+
+    for (const auto &range : ranges)
+    {
+        // meshlets never straddle ranges, since every range has its own base vertex
+        auto rangeEnd = range.firstIndex + range.indexCount;
+        for (uint32_t i = range.firstIndex; i < rangeEnd;)
+        {
+            Meshlet meshlet{};
+            meshlet.firstIndex = i;
+            meshlet.baseVertex = range.baseVertex;
+            auto meshletIndex = (uint32_t)meshlets.size();
+            uint32_t meshletVertexCount = 0;
+            for (; i < rangeEnd && meshlet.indexCount < maxTriangleCount * 3; i += 3)
+            {
+                uint32_t newVertexCount = 0;
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    // a vertex repeated within the triangle is only new once
+                    newVertexCount += vertexMeshlets[indices[i + j]] != meshletIndex && std::find(indices + i, indices + i + j, indices[i + j]) == indices + i + j;
+                }
+                if (meshletVertexCount + newVertexCount > maxVertexCount)
+                {
+                    break;
+                }
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    vertexMeshlets[indices[i + j]] = meshletIndex;
+                }
+                meshletVertexCount += newVertexCount;
+                meshlet.indexCount += 3;
+            }
+            computeBounds(indices, positions, vertexStride, meshlet);
+            meshlets.emplace_back(meshlet);
+        }
+    }
+
+    return meshlets;
+}
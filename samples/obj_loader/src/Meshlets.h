@@ -0,0 +1,28 @@
+#ifndef MESHLETS_H
+#define MESHLETS_H
+
+#include "MeshOptimizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// a run of consecutive triangles, drawn with vkCmdDrawIndexed(indexCount, 1, firstIndex, baseVertex, 0)
+struct Meshlet
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t baseVertex;
+    float center[3];
+    float radius;
+    // the meshlet faces away from any eye where dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius
+    // (a cutoff of 1 means its triangles face too many directions to ever be culled)
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+// splits every index range into meshlets of consecutive triangles with at most maxVertexCount unique vertices and maxTriangleCount triangles.
+// works best on vertex cache optimized indices. indices aren't compacted yet, positions are 3 floats, vertexStride bytes apart
+std::vector<Meshlet> buildMeshlets(const uint32_t *indices, const std::vector<IndexRange> &ranges, const float *positions, size_t vertexCount, size_t vertexStride, uint32_t maxVertexCount, uint32_t maxTriangleCount);
+
+#endif
@@ -1,13 +1,35 @@
 #include "ObjLoaderApplication.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlets.h"
+#include "ObjParser.h"
+#include "ParserBenchmark.h"
+#include "VertexDeduplicator.h"
+#include "VertexQuantization.h"
+
+#include <vkfw/AsyncFileReader.h>
+#include <vkfw/FrustumCulling.h>
+#include <vkfw/GeometryArena.h>
+#include <vkfw/MappedFile.h>
+#include <vkfw/PushConstants.h>
+
+#if defined VKFW_EMBED_SPIRV
+#include <embedded_spirv.h>
+#endif
 
-#define TINYOBJ_LOADER_C_IMPLEMENTATION
-#include "tinyobj_loader_c.h"
-
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <iostream>
 #include <functional>
-#include <numeric>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 struct Vertex
@@ -17,84 +39,288 @@ struct Vertex
     float uv[2];
 };
 
+// 16 bytes: positions normalized to the mesh bounds, octahedral normals and half-float uvs
+struct QuantizedVertex
+{
+    // w is padding (there's no mandatory 3-component 16-bit vertex format)
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+// vertices and indices live in the model's geometry arena
 struct Mesh
 {
-    Buffer vertexBuffer;
-    Buffer stagingVertexBuffer;
-    Buffer indexBuffer;
-    Buffer stagingIndexBuffer;
+    vkfw::GeometryAllocation geometry;
+    size_t vertexCount;
     size_t indexCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    // around the center of the bounds
+    float boundingRadius;
+    VkIndexType indexType;
+    std::vector<IndexRange> indexRanges;
+    // into the model's meshlets
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+    // the full resolution mesh first, at least
+    std::vector<MeshLod> lods;
+};
+
+// consecutive meshes drawn by a single indirect draw: they share a geometry arena block, an index type and
+// (with quantized vertices, whose dequantization is pushed per group) the mesh itself
+struct DrawGroup
+{
+    uint32_t block;
+    VkIndexType indexType;
+    uint32_t firstMesh;
+    // the culled draws of all the group's meshes are compacted into a region of the draw commands
+    uint32_t firstDraw;
+    uint32_t maxDrawCount;
 };
 
 struct Model
 {
+    std::unique_ptr<vkfw::GeometryArena> geometry;
+    // only for models uploaded at once (streamed meshes go through the staging ring)
+    Buffer stagingBuffer;
     std::vector<Mesh> meshes;
+    // one per mesh, culled every frame (on the cpu, unless culled on the gpu)
+    vkfw::BoundingVolumes meshBounds;
+    std::vector<uint8_t> meshVisibility;
+    // only if culled on the gpu, either meshlets or instances (and their draw templates).
+    // draw buffers are per frame in flight
+    Buffer meshletBuffer;
+    uint32_t meshletCount{0};
+    Buffer instanceBuffer;
+    Buffer drawTemplateBuffer;
+    std::vector<DrawGroup> drawGroups;
+    uint32_t drawCount{0};
+    std::vector<Buffer> drawCommandBuffers;
+    std::vector<Buffer> drawCountBuffers;
 };
 
-constexpr VkFormat gc_depthStencilFormat = VK_FORMAT_D32_SFLOAT;
+// matches Meshlet in meshlet_cull.comp
+struct GpuMeshlet
+{
+    float boundingSphere[4];
+    float cone[4];
+    // mesh bounding sphere, so that all the meshlets of a mesh pick the same lod
+    float lodBounds[4];
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;
+    uint32_t drawOffset;
+    float lodError;
+    // FLT_MAX for the coarsest lod
+    float coarserLodError;
+    uint32_t drawGroup;
+    uint32_t padding;
+};
 
-namespace
+// matches Instance in instance_cull.comp, one per mesh
+struct GpuInstance
+{
+    float boundingSphere[4];
+    // w is padding
+    float extent[4];
+    // only the first lodCount are used
+    float lodErrors[4];
+    // into the draw templates (one VkDrawIndexedIndirectCommand per index range)
+    uint32_t lodFirstDraws[4];
+    uint32_t lodDrawCounts[4];
+    uint32_t lodCount;
+    uint32_t drawOffset;
+    // the first of the consecutive draw groups the instance's draws are split across
+    uint32_t drawGroup;
+    uint32_t maxGroupDrawCount;
+};
+
+// vertices are replaced by quantizedVertices once quantized, and indices by compactIndices once compacted.
+// indices, index ranges and meshlets hold every lod, one after the other
+struct MeshData
 {
-    void createRenderPass(VkDevice device, const VkAllocationCallbacks *allocCb, VkFormat colorAttachmentFormat, VkFormat depthStencilAttachmentFormat, VkRenderPass &renderPass)
-    {
-        VkAttachmentDescription attachmentDescriptions[2];
-
-        auto &colorAttachmentDescription = attachmentDescriptions[0];
-        colorAttachmentDescription.flags = 0;
-        colorAttachmentDescription.format = colorAttachmentFormat;
-        colorAttachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        auto &depthStencilAttachmentDescription = attachmentDescriptions[1];
-        depthStencilAttachmentDescription.flags = 0;
-        depthStencilAttachmentDescription.format = depthStencilAttachmentFormat;
-        depthStencilAttachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
-        depthStencilAttachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        depthStencilAttachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        depthStencilAttachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        depthStencilAttachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depthStencilAttachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        depthStencilAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_STENCIL_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference colorAttachmentReference;
-        colorAttachmentReference.attachment = 0;
-        colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentReference depthStencilAttachmentReference;
-        depthStencilAttachmentReference.attachment = 1;
-        depthStencilAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_STENCIL_READ_ONLY_OPTIMAL;
-
-        VkSubpassDescription subpassDescription;
-        subpassDescription.flags = 0;
-        subpassDescription.colorAttachmentCount = 1;
-        subpassDescription.pColorAttachments = &colorAttachmentReference;
-        subpassDescription.pDepthStencilAttachment = &depthStencilAttachmentReference;
-        subpassDescription.inputAttachmentCount = 0;
-        subpassDescription.pInputAttachments = nullptr;
-        subpassDescription.preserveAttachmentCount = 0;
-        subpassDescription.pPreserveAttachments = nullptr;
-        subpassDescription.pResolveAttachments = nullptr;
-        subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-
-        VkRenderPassCreateInfo renderPassCreateInfo;
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.pNext = nullptr;
-        renderPassCreateInfo.flags = 0;
-        renderPassCreateInfo.attachmentCount = vkfwArraySize(attachmentDescriptions);
-        renderPassCreateInfo.pAttachments = attachmentDescriptions;
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpassDescription;
-        renderPassCreateInfo.dependencyCount = 0;
-        renderPassCreateInfo.pDependencies = nullptr;
-
-        vkfwCheckVkResult(vkCreateRenderPass(device, &renderPassCreateInfo, allocCb, &renderPass));
+    std::vector<Vertex> vertices;
+    std::vector<QuantizedVertex> quantizedVertices;
+    std::vector<uint32_t> indices;
+    std::vector<uint16_t> compactIndices;
+    std::vector<IndexRange> indexRanges;
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshLod> lods;
+    float boundsMin[3];
+    float boundsMax[3];
+    float boundingRadius;
+};
+
+inline const void *getVertexData(const MeshData &mesh)
+{
+    return mesh.quantizedVertices.empty() ? static_cast<const void *>(mesh.vertices.data()) : mesh.quantizedVertices.data();
+}
+
+inline size_t getVertexCount(const MeshData &mesh)
+{
+    return mesh.vertices.size() + mesh.quantizedVertices.size();
+}
+
+inline size_t getVertexDataSize(const MeshData &mesh)
+{
+    return sizeof(Vertex) * mesh.vertices.size() + sizeof(QuantizedVertex) * mesh.quantizedVertices.size();
+}
+
+inline const void *getIndexData(const MeshData &mesh)
+{
+    return mesh.compactIndices.empty() ? static_cast<const void *>(mesh.indices.data()) : mesh.compactIndices.data();
+}
+
+inline size_t getIndexCount(const MeshData &mesh)
+{
+    return mesh.indices.size() + mesh.compactIndices.size();
+}
+
+inline uint32_t getIndexSize(const MeshData &mesh)
+{
+    return mesh.compactIndices.empty() ? sizeof(uint32_t) : sizeof(uint16_t);
+}
+
+inline size_t getIndexDataSize(const MeshData &mesh)
+{
+    return sizeof(uint32_t) * mesh.indices.size() + sizeof(uint16_t) * mesh.compactIndices.size();
+}
+
+// meshes either point into parsedMeshes or into the mapped mesh cache
+struct ModelData
+{
+    std::vector<MeshData> parsedMeshes;
+    vkfw::MappedFile meshCache;
+    std::vector<MeshCacheMesh> meshes;
+};
+
+// bitmask of the loader steps that change the generated vertices/indices (part of the mesh cache key)
+enum LoaderOptions : uint32_t
+{
+    DeduplicateVertices = 1 << 0,
+    OptimizeVertexCache = 1 << 1,
+    OptimizeOverdraw = 1 << 2,
+    OptimizeVertexFetch = 1 << 3,
+    QuantizeVertices = 1 << 4,
+    // 16-bit indices for meshes with up to 65536 vertices
+    CompactIndices = 1 << 5,
+    // bigger meshes are split into ranges of 65536 vertices (drawn with a base vertex each) so that they can be compacted too
+    SplitIndexRanges = 1 << 6,
+    // for culling clusters of triangles on the gpu
+    BuildMeshlets = 1 << 7,
+    // simplified versions of every mesh, picked by their projected error
+    GenerateLods = 1 << 8
+};
+
+constexpr uint32_t gc_defaultLoaderOptions = DeduplicateVertices | OptimizeVertexCache | OptimizeOverdraw | OptimizeVertexFetch | CompactIndices | SplitIndexRanges | BuildMeshlets | GenerateLods;
+constexpr uint32_t gc_maxCompactIndexVertexSpan = 1 << 16;
+// how much worse the ACMR can get for less overdraw
+constexpr float gc_overdrawThreshold = 1.05f;
+constexpr uint32_t gc_maxMeshletVertexCount = 64;
+constexpr uint32_t gc_maxMeshletTriangleCount = 124;
+// matches local_size_x in meshlet_cull.comp
+constexpr uint32_t gc_meshletCullGroupSize = 64;
+// matches local_size_x in instance_cull.comp
+constexpr uint32_t gc_instanceCullGroupSize = 64;
+// including the full resolution one
+constexpr size_t gc_maxLodCount = 4;
+// every lod aims at this fraction of the previous lod's triangles, and is dropped if it can't get below gc_minLodReduction of them
+constexpr float gc_lodIndexRatio = 0.5f;
+constexpr float gc_minLodReduction = 0.8f;
+// how far the coarsest lod can be from the full resolution mesh, relative to the mesh extent
+constexpr float gc_maxLodRelativeError = 0.05f;
+// the coarsest lod whose error projects to at most this many pixels is drawn
+constexpr float gc_lodErrorThreshold = 1.0f;
+
+// streaming: the obj is read in windows, every batch of faces becomes a mesh and only a few meshes can wait for upload at a time
+constexpr size_t gc_streamWindowSize = 16 << 20;
+constexpr size_t gc_streamBatchFaceCount = 1 << 15;
+constexpr size_t gc_maxQueuedStreamedMeshes = 4;
+// one region per frame in flight
+constexpr VkDeviceSize gc_stagingRegionSize = 8 << 20;
+
+// streamed meshes are packed into blocks of these sizes (models uploaded at once get a single block that fits them)
+constexpr VkDeviceSize gc_geometryBlockVertexSize = 64 << 20;
+constexpr VkDeviceSize gc_geometryBlockIndexSize = 32 << 20;
+
+static_assert(gc_maxLodCount <= 4, "instance_cull.comp holds at most 4 lods per instance");
+// (no lod has more indices than the full resolution mesh)
+static_assert(gc_streamBatchFaceCount * 3 * (sizeof(Vertex) + gc_maxLodCount * sizeof(uint32_t)) <= gc_stagingRegionSize, "a streamed mesh must fit in a staging region");
+
+// bounded queue between the streaming parser and the render thread (the parser waits for uploads to catch up)
+struct MeshStream
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<MeshData> meshes;
+    bool cancelled{false};
+
+    // false if the stream was cancelled
+    bool push(MeshData mesh)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]()
+                       { return cancelled || meshes.size() < gc_maxQueuedStreamedMeshes; });
+        if (cancelled)
+        {
+            return false;
+        }
+        meshes.emplace_back(std::move(mesh));
+        return true;
+    }
+
+    // only pops the next mesh if it takes at most maxSize bytes
+    bool tryPop(size_t maxSize, MeshData &mesh)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (meshes.empty() || getVertexDataSize(meshes.front()) + getIndexDataSize(meshes.front()) > maxSize)
+            {
+                return false;
+            }
+            mesh = std::move(meshes.front());
+            meshes.pop_front();
+        }
+        condition.notify_one();
+        return true;
+    }
+
+    void cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled = true;
+        }
+        condition.notify_all();
     }
+};
+
+struct BufferUpload
+{
+    VkBuffer source;
+    VkDeviceSize sourceOffset;
+    VkBuffer destination;
+    VkDeviceSize destinationOffset;
+    VkDeviceSize size;
+};
 
+// matches the constant_ids in lambert.frag
+struct LambertSpecialization
+{
+    float ambient{0.1f};
+};
+
+// matches the constant_ids in lambert.vert
+struct LambertVertexSpecialization
+{
+    VkBool32 quantizedVertices{VK_FALSE};
+};
+
+constexpr VkFormat gc_depthStencilFormat = VK_FORMAT_D32_SFLOAT;
+
+namespace
+{
     void beginRenderPass(VkCommandBuffer commandBuffer, VkRenderPass renderPass, uint32_t width, uint32_t height, VkFramebuffer framebuffer)
     {
         const VkClearValue clearValues[] = {VkClearValue{0, 0, 0, 1},
@@ -112,7 +338,7 @@ namespace
         vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
     }
 
-    void createPipelineLayout(VkDevice device, const VkAllocationCallbacks *allocCb, PipelineLayout &pipelineLayout)
+    void createPipelineLayout(VkDevice device, const VkAllocationCallbacks *allocCb, const VkPushConstantRange *pushConstantRanges, uint32_t pushConstantRangeCount, PipelineLayout &pipelineLayout)
     {
         VkDescriptorSetLayoutBinding descriptorSetLayoutBinding;
         descriptorSetLayoutBinding.binding = 0;
@@ -136,190 +362,79 @@ namespace
         pipelineLayoutCreateInfo.flags = 0;
         pipelineLayoutCreateInfo.setLayoutCount = 1;
         pipelineLayoutCreateInfo.pSetLayouts = &pipelineLayout.descriptorSetLayout;
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-        pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = pushConstantRangeCount;
+        pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges;
 
         vkfwCheckVkResult(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, allocCb, &pipelineLayout.handle));
     }
 
-    void initShaderStageCreateInfo(VkShaderModule module, VkShaderStageFlagBits stage, VkPipelineShaderStageCreateInfo &shaderStageCreateInfo)
-    {
-        shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        shaderStageCreateInfo.pNext = nullptr;
-        shaderStageCreateInfo.flags = 0;
-        shaderStageCreateInfo.module = module;
-        shaderStageCreateInfo.stage = stage;
-        shaderStageCreateInfo.pName = "main";
-        shaderStageCreateInfo.pSpecializationInfo = nullptr;
-    }
-
-    void createGraphicsPipeline(VkDevice device, const VkAllocationCallbacks *allocCb, VkShaderModule vertModule, VkShaderModule fragModule, VkPipelineLayout pipelineLayout, VkRenderPass renderPass, VkPipeline &pipeline)
-    {
-        VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo;
-        graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        graphicsPipelineCreateInfo.pNext = nullptr;
-        graphicsPipelineCreateInfo.flags = 0;
-
-        graphicsPipelineCreateInfo.layout = pipelineLayout;
-        graphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-        graphicsPipelineCreateInfo.basePipelineIndex = 0;
-        graphicsPipelineCreateInfo.renderPass = renderPass;
-        graphicsPipelineCreateInfo.subpass = 0;
-
-        VkPipelineShaderStageCreateInfo shaderStageCreateInfos[2];
-        initShaderStageCreateInfo(vertModule, VK_SHADER_STAGE_VERTEX_BIT, shaderStageCreateInfos[0]);
-        initShaderStageCreateInfo(fragModule, VK_SHADER_STAGE_FRAGMENT_BIT, shaderStageCreateInfos[1]);
-        graphicsPipelineCreateInfo.stageCount = vkfwArraySize(shaderStageCreateInfos);
-        graphicsPipelineCreateInfo.pStages = shaderStageCreateInfos;
-
-        const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo;
-        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCreateInfo.pNext = nullptr;
-        dynamicStateCreateInfo.flags = 0;
-        dynamicStateCreateInfo.dynamicStateCount = vkfwArraySize(dynamicStates);
-        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
-        graphicsPipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
-
-        const VkVertexInputBindingDescription vertexInputBindingDescriptions[] = {VkVertexInputBindingDescription{0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX}};
-
-        const VkVertexInputAttributeDescription vertexInputAttributeDescriptions[] = {VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position)},
-                                                                                      VkVertexInputAttributeDescription{1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal)},
-                                                                                      VkVertexInputAttributeDescription{2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv)}};
-
-        VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
-        vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputStateCreateInfo.pNext = nullptr;
-        vertexInputStateCreateInfo.flags = 0;
-        vertexInputStateCreateInfo.vertexBindingDescriptionCount = vkfwArraySize(vertexInputBindingDescriptions);
-        vertexInputStateCreateInfo.pVertexBindingDescriptions = vertexInputBindingDescriptions;
-        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = vkfwArraySize(vertexInputAttributeDescriptions);
-        vertexInputStateCreateInfo.pVertexAttributeDescriptions = vertexInputAttributeDescriptions;
-        graphicsPipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
-
-        VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo;
-        inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssemblyStateCreateInfo.pNext = nullptr;
-        inputAssemblyStateCreateInfo.flags = 0;
-        inputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
-        graphicsPipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
-
-        VkViewport viewport{};
-        VkRect2D scissorRect{};
-
-        VkPipelineViewportStateCreateInfo viewportStateCreateInfo;
-        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportStateCreateInfo.pNext = nullptr;
-        viewportStateCreateInfo.flags = 0;
-        // even though we define viewport and scissor as dynamic states, we need to setup them
-        // cause spec states that if the multiple viewports feature is not enabled, viewportCount/scissorCount must be 1
-        // source: https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#VUID-VkPipelineViewportStateCreateInfo-viewportCount-01216
-        viewportStateCreateInfo.viewportCount = 1;
-        viewportStateCreateInfo.pViewports = &viewport;
-        viewportStateCreateInfo.scissorCount = 1;
-        viewportStateCreateInfo.pScissors = &scissorRect;
-        graphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-
-        VkPipelineRasterizationStateCreateInfo rasterizationStateCreateInfo;
-        rasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizationStateCreateInfo.pNext = nullptr;
-        rasterizationStateCreateInfo.flags = 0;
-        rasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
-        rasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-        rasterizationStateCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizationStateCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
-        rasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
-        rasterizationStateCreateInfo.depthBiasConstantFactor = 0;
-        rasterizationStateCreateInfo.depthBiasClamp = 0;
-        rasterizationStateCreateInfo.depthBiasSlopeFactor = 0;
-        rasterizationStateCreateInfo.lineWidth = 1;
-        graphicsPipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
-
-        VkPipelineMultisampleStateCreateInfo multisampleStateCreateInfo;
-        multisampleStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampleStateCreateInfo.pNext = nullptr;
-        multisampleStateCreateInfo.flags = 0;
-        multisampleStateCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        multisampleStateCreateInfo.sampleShadingEnable = VK_FALSE;
-        multisampleStateCreateInfo.minSampleShading = 0;
-        multisampleStateCreateInfo.pSampleMask = nullptr;
-        multisampleStateCreateInfo.alphaToCoverageEnable = VK_FALSE;
-        multisampleStateCreateInfo.alphaToOneEnable = VK_FALSE;
-        graphicsPipelineCreateInfo.pMultisampleState = &multisampleStateCreateInfo;
-
-        VkPipelineColorBlendAttachmentState colorBlendAttachmentState;
-        colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachmentState.blendEnable = VK_FALSE;
-        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
-
-        VkPipelineColorBlendStateCreateInfo colorBlendStateCreateInfo;
-        colorBlendStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlendStateCreateInfo.pNext = nullptr;
-        colorBlendStateCreateInfo.flags = 0;
-        colorBlendStateCreateInfo.logicOpEnable = VK_FALSE;
-        colorBlendStateCreateInfo.logicOp = VK_LOGIC_OP_CLEAR;
-        colorBlendStateCreateInfo.attachmentCount = 1;
-        colorBlendStateCreateInfo.pAttachments = &colorBlendAttachmentState;
-        colorBlendStateCreateInfo.blendConstants[0] = 0;
-        colorBlendStateCreateInfo.blendConstants[1] = 0;
-        colorBlendStateCreateInfo.blendConstants[2] = 0;
-        colorBlendStateCreateInfo.blendConstants[3] = 0;
-        graphicsPipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
-
-        VkPipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo;
-        depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-        depthStencilStateCreateInfo.pNext = nullptr;
-        depthStencilStateCreateInfo.flags = 0;
-        depthStencilStateCreateInfo.depthTestEnable = VK_TRUE;
-        depthStencilStateCreateInfo.depthWriteEnable = VK_TRUE;
-        depthStencilStateCreateInfo.depthCompareOp = VK_COMPARE_OP_LESS;
-        depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
-        depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
-        depthStencilStateCreateInfo.front = {};
-        depthStencilStateCreateInfo.back = {};
-        depthStencilStateCreateInfo.minDepthBounds = 0;
-        depthStencilStateCreateInfo.maxDepthBounds = 0;
-        graphicsPipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
-
-        vkfwCheckVkResult(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo, allocCb, &pipeline));
-    }
-
-    void createFramebuffer(VkDevice device, const VkAllocationCallbacks *allocCb, VkRenderPass renderPass, VkImageView colorAttachmentImageView, VkImageView depthStencilImageView, uint32_t width, uint32_t height, VkFramebuffer &framebuffer)
-    {
-        const VkImageView attachments[] = {colorAttachmentImageView, depthStencilImageView};
-
-        VkFramebufferCreateInfo framebufferCreateInfo;
-        framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferCreateInfo.pNext = nullptr;
-        framebufferCreateInfo.flags = 0;
-        framebufferCreateInfo.renderPass = renderPass;
-        framebufferCreateInfo.attachmentCount = vkfwArraySize(attachments);
-        framebufferCreateInfo.pAttachments = attachments;
-        framebufferCreateInfo.width = width;
-        framebufferCreateInfo.height = height;
-        framebufferCreateInfo.layers = 1;
-
-        vkfwCheckVkResult(vkCreateFramebuffer(device, &framebufferCreateInfo, allocCb, &framebuffer));
-    }
-
-    void createDescriptorPool(VkDevice device, const VkAllocationCallbacks *allocCb, uint32_t descriptorCount, VkDescriptorPool &descriptorPool)
+    // storage buffers read/written by a cull shader (meshlets, or instances and draw templates, followed by draw commands and draw counts)
+    void createCullPipelineLayout(VkDevice device, const VkAllocationCallbacks *allocCb, uint32_t bufferCount, const VkPushConstantRange *pushConstantRanges, uint32_t pushConstantRangeCount, PipelineLayout &pipelineLayout)
+    {
+        std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings(bufferCount);
+        for (uint32_t i = 0; i < bufferCount; ++i)
+        {
+            descriptorSetLayoutBindings[i].binding = i;
+            descriptorSetLayoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorSetLayoutBindings[i].descriptorCount = 1;
+            descriptorSetLayoutBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            descriptorSetLayoutBindings[i].pImmutableSamplers = nullptr;
+        }
+
+        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo;
+        descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        descriptorSetLayoutCreateInfo.pNext = nullptr;
+        descriptorSetLayoutCreateInfo.flags = 0;
+        descriptorSetLayoutCreateInfo.bindingCount = bufferCount;
+        descriptorSetLayoutCreateInfo.pBindings = descriptorSetLayoutBindings.data();
+
+        vkfwCheckVkResult(vkCreateDescriptorSetLayout(device, &descriptorSetLayoutCreateInfo, allocCb, &pipelineLayout.descriptorSetLayout));
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo;
+        pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCreateInfo.pNext = nullptr;
+        pipelineLayoutCreateInfo.flags = 0;
+        pipelineLayoutCreateInfo.setLayoutCount = 1;
+        pipelineLayoutCreateInfo.pSetLayouts = &pipelineLayout.descriptorSetLayout;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = pushConstantRangeCount;
+        pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges;
+
+        vkfwCheckVkResult(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, allocCb, &pipelineLayout.handle));
+    }
+
+    VkPipeline createComputePipeline(VkDevice device, const VkAllocationCallbacks *allocCb, VkPipelineCache pipelineCache, VkPipelineLayout pipelineLayout, VkShaderModule shaderModule)
+    {
+        VkComputePipelineCreateInfo computePipelineCreateInfo;
+        computePipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        computePipelineCreateInfo.pNext = nullptr;
+        computePipelineCreateInfo.flags = 0;
+        computePipelineCreateInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        computePipelineCreateInfo.stage.pNext = nullptr;
+        computePipelineCreateInfo.stage.flags = 0;
+        computePipelineCreateInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        computePipelineCreateInfo.stage.module = shaderModule;
+        computePipelineCreateInfo.stage.pName = "main";
+        computePipelineCreateInfo.stage.pSpecializationInfo = nullptr;
+        computePipelineCreateInfo.layout = pipelineLayout;
+        computePipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+        computePipelineCreateInfo.basePipelineIndex = -1;
+
+        VkPipeline pipeline;
+        vkfwCheckVkResult(vkCreateComputePipelines(device, pipelineCache, 1, &computePipelineCreateInfo, allocCb, &pipeline));
+        return pipeline;
+    }
+
+    void createDescriptorPool(VkDevice device, const VkAllocationCallbacks *allocCb, VkDescriptorType descriptorType, uint32_t descriptorCount, uint32_t maxSets, VkDescriptorPool &descriptorPool)
     {
         VkDescriptorPoolSize poolSize;
-        poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSize.type = descriptorType;
         poolSize.descriptorCount = descriptorCount;
 
         VkDescriptorPoolCreateInfo descriptorPoolCreateInfo;
         descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         descriptorPoolCreateInfo.pNext = nullptr;
         descriptorPoolCreateInfo.flags = 0;
-        descriptorPoolCreateInfo.maxSets = descriptorCount;
+        descriptorPoolCreateInfo.maxSets = maxSets;
         descriptorPoolCreateInfo.poolSizeCount = 1;
         descriptorPoolCreateInfo.pPoolSizes = &poolSize;
 
@@ -340,22 +455,20 @@ namespace
         vkfwCheckVkResult(vkAllocateDescriptorSets(device, &allocateInfo, &descriptorSets[0]))
     }
 
-    VkShaderModule createShaderModule(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::FileData &code)
+    VkShaderModule createShaderModule(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::ShaderCode &code)
     {
         VkShaderModuleCreateInfo shaderModuleCreateInfo;
         shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
         shaderModuleCreateInfo.pNext = nullptr;
         shaderModuleCreateInfo.flags = 0;
         shaderModuleCreateInfo.codeSize = code.size;
-        shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t *>(code.value.get());
+        shaderModuleCreateInfo.pCode = code.code;
         VkShaderModule shaderModule;
         vkfwCheckVkResult(vkCreateShaderModule(device, &shaderModuleCreateInfo, allocCb, &shaderModule));
         return shaderModule;
     }
 
-    using FindMemoryTypeCb = std::function<uint32_t(uint32_t, VkMemoryPropertyFlags)>;
-
-    VkDeviceMemory allocateMemory(VkDevice device, const VkAllocationCallbacks *allocCb, const FindMemoryTypeCb &findMemoryTypeCb, VkMemoryPropertyFlags properties, VkMemoryRequirements memoryRequirements)
+    VkDeviceMemory allocateMemory(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::FindMemoryTypeCb &findMemoryTypeCb, VkMemoryPropertyFlags properties, VkMemoryRequirements memoryRequirements)
     {
         VkMemoryAllocateInfo memAllocInfo;
         memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -369,7 +482,7 @@ namespace
         return deviceMemory;
     }
 
-    Buffer createBuffer(VkDevice device, const VkAllocationCallbacks *allocCb, const FindMemoryTypeCb &findMemoryTypeCb, size_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
+    Buffer createBuffer(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::FindMemoryTypeCb &findMemoryTypeCb, size_t size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties)
     {
         VkBufferCreateInfo bufferCreateInfo;
         bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -395,39 +508,6 @@ namespace
         return buffer;
     }
 
-    Image createImage(VkDevice device, const VkAllocationCallbacks *allocCb, const FindMemoryTypeCb &findMemoryTypeCb, VkFormat format, uint32_t width, uint32_t height, VkImageUsageFlags usage, VkMemoryPropertyFlags properties)
-    {
-        VkImageCreateInfo imageCreateInfo;
-        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        imageCreateInfo.pNext = nullptr;
-        imageCreateInfo.flags = 0;
-        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-        imageCreateInfo.format = format;
-        imageCreateInfo.extent = {width, height, 1};
-        imageCreateInfo.mipLevels = 1;
-        imageCreateInfo.arrayLayers = 1;
-        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageCreateInfo.usage = usage;
-        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        imageCreateInfo.queueFamilyIndexCount = 0;
-        imageCreateInfo.pQueueFamilyIndices = nullptr;
-        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-        Image image;
-
-        vkfwCheckVkResult(vkCreateImage(device, &imageCreateInfo, allocCb, &image.handle));
-
-        VkMemoryRequirements memoryRequirements;
-        vkGetImageMemoryRequirements(device, image.handle, &memoryRequirements);
-
-        image.backingMemory = allocateMemory(device, allocCb, findMemoryTypeCb, properties, memoryRequirements);
-
-        vkfwCheckVkResult(vkBindImageMemory(device, image.handle, image.backingMemory, 0));
-
-        return image;
-    }
-
     void createImageView(VkDevice device, const VkAllocationCallbacks *allocCb, VkFormat format, VkImage image, VkImageAspectFlags aspectMask, VkImageView &imageView)
     {
         VkImageViewCreateInfo imageViewCreateInfo;
@@ -453,117 +533,601 @@ namespace
         vkFreeMemory(device, buffer.backingMemory, allocCb);
     }
 
-    template <typename data_t>
-    void copyToMappedMemory(VkDevice device, const VkAllocationCallbacks *allocCb, VkDeviceMemory memory, const std::vector<data_t> &data)
+    void copyToMappedMemory(VkDevice device, const VkAllocationCallbacks *allocCb, VkDeviceMemory memory, const void *data, VkDeviceSize size)
     {
-        data_t *mappedData;
-        vkfwCheckVkResult(vkMapMemory(device, memory, 0, sizeof(data_t) * data.size(), 0, (void **)&mappedData));
+        void *mappedData;
+        vkfwCheckVkResult(vkMapMemory(device, memory, 0, size, 0, &mappedData));
         if (mappedData != nullptr)
         {
-            memcpy(mappedData, &data[0], sizeof(data_t) * data.size());
+            memcpy(mappedData, data, (size_t)size);
             vkUnmapMemory(device, memory);
         }
     }
 
-    using ImportContext = std::vector<decltype(vkfw::FileData::value)>;
+    template <typename data_t>
+    void copyToMappedMemory(VkDevice device, const VkAllocationCallbacks *allocCb, VkDeviceMemory memory, const std::vector<data_t> &data)
+    {
+        copyToMappedMemory(device, allocCb, memory, &data[0], sizeof(data_t) * data.size());
+    }
 
-    void readFileCallback(void *ctx, const char *filename, int is_mtl, const char *obj_filename, char **buf, size_t *len)
+    void buildMesh(const ObjData &objData, const ObjShape &shape, MeshData &mesh)
     {
-        auto *importContext = static_cast<ImportContext *>(ctx);
-        auto fileData = vkfw::readFile(filename);
-        *buf = fileData.value.get();
-        *len = fileData.size;
-        importContext->emplace_back(std::move(fileData.value));
+        auto &vertices = mesh.vertices;
+        auto &indices = mesh.indices;
+
+        // corners sharing position, normal and uv become a single vertex
+        VertexDeduplicator vertexDeduplicator(shape.faceCount);
+        indices.reserve(shape.faceCount * 3);
+
+        for (size_t j = shape.faceOffset * 3; j < (shape.faceOffset + shape.faceCount) * 3; ++j)
+        {
+            const auto &objIndex = objData.indices[j];
+            auto index = vertexDeduplicator.insert({objIndex.position, objIndex.normal, objIndex.uv});
+            indices.emplace_back(index.first);
+            if (!index.second)
+            {
+                continue;
+            }
+
+            Vertex vertex{};
+            if (objIndex.position != gc_objMissingIndex)
+            {
+                memcpy(vertex.position, &objData.positions[(size_t)objIndex.position * 3], sizeof(float) * 3);
+            }
+            if (objIndex.normal != gc_objMissingIndex)
+            {
+                memcpy(vertex.normal, &objData.normals[(size_t)objIndex.normal * 3], sizeof(float) * 3);
+            }
+            if (objIndex.uv != gc_objMissingIndex)
+            {
+                memcpy(vertex.uv, &objData.uvs[(size_t)objIndex.uv * 2], sizeof(float) * 2);
+            }
+            vertices.emplace_back(vertex);
+        }
     }
-    std::unique_ptr<Model> loadModel(VkDevice device, const VkAllocationCallbacks *allocCb, const FindMemoryTypeCb &findMemoryTypeCb, VkCommandBuffer commandBuffer, const std::string &modelPath)
+
+    // every lod simplifies the previous one, so their errors add up. lods only have their own indices, vertices are shared
+    void generateLods(MeshData &mesh, uint32_t loaderOptions)
     {
-        std::unique_ptr<Model> model;
+        mesh.lods = {MeshLod{0, (uint32_t)mesh.indices.size(), 0, 0, 0, 0, 0}};
+        if ((loaderOptions & GenerateLods) == 0)
+        {
+            return;
+        }
 
-        tinyobj_attrib_t attributes;
-        tinyobj_shape_t *shapes;
-        tinyobj_material_t *materials;
-        size_t shapeCount, materialCount;
-        ImportContext importContext;
+        float boundsMin[3], boundsMax[3];
+        memcpy(boundsMin, mesh.vertices[0].position, sizeof(boundsMin));
+        memcpy(boundsMax, mesh.vertices[0].position, sizeof(boundsMax));
+        for (const auto &vertex : mesh.vertices)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                boundsMin[k] = std::min(boundsMin[k], vertex.position[k]);
+                boundsMax[k] = std::max(boundsMax[k], vertex.position[k]);
+            }
+        }
+        auto maxError = gc_maxLodRelativeError * std::max({boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2]});
 
-        if (tinyobj_parse_obj(&attributes,
-                              &shapes,
-                              &shapeCount,
-                              &materials,
-                              &materialCount,
-                              modelPath.c_str(),
-                              &readFileCallback,
-                              (void *)&importContext,
-                              TINYOBJ_FLAG_TRIANGULATE) == TINYOBJ_SUCCESS)
+        std::vector<uint32_t> lodIndices(mesh.indices.size());
+        while (mesh.lods.size() < gc_maxLodCount)
         {
-            model = std::make_unique<Model>();
+            auto previousLod = mesh.lods.back();
+            float error;
+            auto indexCount = simplifyMesh(lodIndices.data(), mesh.indices.data() + previousLod.firstIndex, previousLod.indexCount, mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex),
+                                           (size_t)(previousLod.indexCount / 3 * gc_lodIndexRatio) * 3, maxError - previousLod.error, error);
+            if (indexCount == 0 || indexCount > previousLod.indexCount * gc_minLodReduction)
+            {
+                break;
+            }
+            mesh.lods.emplace_back(MeshLod{(uint32_t)mesh.indices.size(), (uint32_t)indexCount, 0, 0, 0, 0, previousLod.error + error});
+            mesh.indices.insert(mesh.indices.end(), lodIndices.begin(), lodIndices.begin() + indexCount);
+        }
+    }
 
-            for (size_t i = 0; i < shapeCount; ++i)
+    // overdraw ordering works on vertex cache ordered triangles, and vertices are reordered for the final triangle order.
+    // lods are optimized on their own, except for the vertex order (which favours the full resolution mesh, since it comes first)
+    void optimizeMesh(MeshData &mesh, uint32_t loaderOptions)
+    {
+        for (const auto &lod : mesh.lods)
+        {
+            if ((loaderOptions & OptimizeVertexCache) != 0)
             {
-                std::vector<Vertex> vertices;
+                optimizeVertexCache(mesh.indices.data() + lod.firstIndex, lod.indexCount, mesh.vertices.size());
+            }
+            if ((loaderOptions & OptimizeOverdraw) != 0)
+            {
+                optimizeOverdraw(mesh.indices.data() + lod.firstIndex, lod.indexCount, mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex), gc_overdrawThreshold);
+            }
+        }
+        if ((loaderOptions & OptimizeVertexFetch) != 0)
+        {
+            std::vector<uint32_t> remap(mesh.vertices.size());
+            std::vector<Vertex> vertices(buildVertexFetchRemap(remap.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.size()));
+            remapIndices(mesh.indices.data(), mesh.indices.size(), remap.data());
+            remapVertices(vertices.data(), mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex), remap.data());
+            mesh.vertices = std::move(vertices);
+        }
+    }
 
-                const auto &shape = shapes[i];
+    inline size_t getVertexStride(uint32_t loaderOptions)
+    {
+        return (loaderOptions & QuantizeVertices) != 0 ? sizeof(QuantizedVertex) : sizeof(Vertex);
+    }
 
-                uint32_t j = 0;
-                uint32_t k = shape.face_offset;
-                while (j < shape.length)
+    // computes the bounds and, if requested, quantizes the vertices against them and compacts the indices
+    void finalizeMesh(MeshData &mesh, uint32_t loaderOptions)
+    {
+        // ranges for every lod, or none at all if any lod can't be split (ie.: a single triangle spans too many vertices)
+        if ((loaderOptions & CompactIndices) != 0)
+        {
+            auto split = mesh.vertices.size() > gc_maxCompactIndexVertexSpan;
+            for (auto &lod : mesh.lods)
+            {
+                lod.firstIndexRange = (uint32_t)mesh.indexRanges.size();
+                if (!split)
                 {
-                    auto vertexCount = attributes.face_num_verts[j++];
-                    assert(vertexCount == 3);
-                    int l = 0;
-                    while (l++ < vertexCount)
+                    mesh.indexRanges.emplace_back(IndexRange{lod.firstIndex, lod.indexCount, 0});
+                }
+                else if ((loaderOptions & SplitIndexRanges) != 0)
+                {
+                    auto lodIndexRanges = splitIndexRanges(mesh.indices.data() + lod.firstIndex, lod.indexCount, gc_maxCompactIndexVertexSpan);
+                    if (lodIndexRanges.empty())
+                    {
+                        mesh.indexRanges.clear();
+                        break;
+                    }
+                    for (auto indexRange : lodIndexRanges)
                     {
-                        Vertex vertex{};
-                        auto &face = attributes.faces[k++];
-                        if (face.v_idx != (int)0x80000000)
-                        {
-                            auto *vertices = attributes.vertices + (intptr_t)(face.v_idx * 3);
-                            memcpy(vertex.position, vertices, sizeof(float) * 3);
-                        }
-                        if (face.vn_idx != (int)0x80000000)
-                        {
-                            auto *normals = attributes.normals + (intptr_t)(face.vn_idx * 3);
-                            memcpy(vertex.normal, normals, sizeof(float) * 3);
-                        }
-                        if (face.vt_idx != (int)0x80000000)
-                        {
-                            auto *uvs = attributes.texcoords + (intptr_t)(face.vt_idx * 2);
-                            memcpy(vertex.uv, uvs, sizeof(float) * 2);
-                        }
-                        vertices.emplace_back(vertex);
+                        indexRange.firstIndex += lod.firstIndex;
+                        mesh.indexRanges.emplace_back(indexRange);
                     }
                 }
+                lod.indexRangeCount = (uint32_t)mesh.indexRanges.size() - lod.firstIndexRange;
+            }
+        }
+        auto compact = !mesh.indexRanges.empty();
+        if (!compact)
+        {
+            for (auto &lod : mesh.lods)
+            {
+                lod.firstIndexRange = (uint32_t)mesh.indexRanges.size();
+                lod.indexRangeCount = 1;
+                mesh.indexRanges.emplace_back(IndexRange{lod.firstIndex, lod.indexCount, 0});
+            }
+        }
+        for (auto &lod : mesh.lods)
+        {
+            // before compaction, meshlets are built from the absolute indices
+            lod.firstMeshlet = (uint32_t)mesh.meshlets.size();
+            if ((loaderOptions & BuildMeshlets) != 0)
+            {
+                std::vector<IndexRange> lodIndexRanges(mesh.indexRanges.begin() + lod.firstIndexRange, mesh.indexRanges.begin() + lod.firstIndexRange + lod.indexRangeCount);
+                auto meshlets = buildMeshlets(mesh.indices.data(), lodIndexRanges, mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex), gc_maxMeshletVertexCount, gc_maxMeshletTriangleCount);
+                mesh.meshlets.insert(mesh.meshlets.end(), meshlets.begin(), meshlets.end());
+            }
+            lod.meshletCount = (uint32_t)mesh.meshlets.size() - lod.firstMeshlet;
+        }
+        if (compact)
+        {
+            mesh.compactIndices.resize(mesh.indices.size());
+            compactIndices(mesh.compactIndices.data(), mesh.indices.data(), mesh.indexRanges);
+            mesh.indices = {};
+        }
+
+        memcpy(mesh.boundsMin, mesh.vertices[0].position, sizeof(float) * 3);
+        memcpy(mesh.boundsMax, mesh.vertices[0].position, sizeof(float) * 3);
+        for (const auto &vertex : mesh.vertices)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                mesh.boundsMin[k] = std::min(mesh.boundsMin[k], vertex.position[k]);
+                mesh.boundsMax[k] = std::max(mesh.boundsMax[k], vertex.position[k]);
+            }
+        }
+        // tighter than the half diagonal of the bounds for anything but a box
+        float squaredRadius = 0;
+        for (const auto &vertex : mesh.vertices)
+        {
+            float squaredDistance = 0;
+            for (int k = 0; k < 3; ++k)
+            {
+                auto distance = vertex.position[k] - (mesh.boundsMin[k] + mesh.boundsMax[k]) * 0.5f;
+                squaredDistance += distance * distance;
+            }
+            squaredRadius = std::max(squaredRadius, squaredDistance);
+        }
+        mesh.boundingRadius = std::sqrt(squaredRadius);
 
-                std::vector<uint32_t> indices;
-                indices.resize(vertices.size());
-                std::iota(indices.begin(), indices.end(), 0);
+        if ((loaderOptions & QuantizeVertices) == 0)
+        {
+            return;
+        }
 
-                auto vertexBufferSize = sizeof(Vertex) * vertices.size();
-                auto indexBuffer = sizeof(uint32_t) * indices.size();
+        mesh.quantizedVertices.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); ++i)
+        {
+            const auto &vertex = mesh.vertices[i];
+            auto &quantizedVertex = mesh.quantizedVertices[i];
+            for (int k = 0; k < 3; ++k)
+            {
+                quantizedVertex.position[k] = quantizeUnorm16(vertex.position[k], mesh.boundsMin[k], mesh.boundsMax[k]);
+            }
+            quantizedVertex.position[3] = 0;
+            encodeOctahedral(vertex.normal, quantizedVertex.normal);
+            quantizedVertex.uv[0] = quantizeHalf(vertex.uv[0]);
+            quantizedVertex.uv[1] = quantizeHalf(vertex.uv[1]);
+        }
+        mesh.vertices = {};
+    }
 
-                Mesh mesh{createBuffer(device, allocCb, findMemoryTypeCb, vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
-                          createBuffer(device, allocCb, findMemoryTypeCb, vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
-                          createBuffer(device, allocCb, findMemoryTypeCb, indexBuffer, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
-                          createBuffer(device, allocCb, findMemoryTypeCb, indexBuffer, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
-                          indices.size()};
+    // positions are normalized to the mesh bounds when quantized
+    void setDequantization(float matrix[16], const float boundsMin[3], const float boundsMax[3])
+    {
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            matrix[i] = 0;
+        }
+        matrix[0] = boundsMax[0] - boundsMin[0];
+        matrix[5] = boundsMax[1] - boundsMin[1];
+        matrix[10] = boundsMax[2] - boundsMin[2];
+        matrix[12] = boundsMin[0];
+        matrix[13] = boundsMin[1];
+        matrix[14] = boundsMin[2];
+        matrix[15] = 1;
+    }
 
-                copyToMappedMemory(device, allocCb, mesh.stagingVertexBuffer.backingMemory, vertices);
-                copyToMappedMemory(device, allocCb, mesh.stagingIndexBuffer.backingMemory, indices);
+    // thread-safe, no vulkan calls
+    std::unique_ptr<ModelData> parseModel(vkfw::AsyncFileReader &fileReader, vkfw::ThreadPool &threadPool, const std::string &modelPath, uint32_t loaderOptions)
+    {
+        auto objFile = fileReader.read(modelPath, vkfw::TaskPriority::High).get();
+
+        auto model = std::make_unique<ModelData>();
 
-                VkBufferCopy copyRegion{0, 0, vertexBufferSize};
-                vkCmdCopyBuffer(commandBuffer, mesh.stagingVertexBuffer.handle, mesh.vertexBuffer.handle, 1, &copyRegion);
+        // written next to the obj, so that subsequent loads only have to hash it
+        auto meshCachePath = modelPath + ".meshcache";
+        MeshCacheKey meshCacheKey{hashMeshCacheSource(objFile.getData(), objFile.getSize(), threadPool), objFile.getSize(), loaderOptions, (uint32_t)getVertexStride(loaderOptions)};
+        model->meshCache = fileReader.read(meshCachePath, vkfw::TaskPriority::High).get();
+        if (model->meshCache.isOpen() && readMeshCache(model->meshCache, meshCacheKey, model->meshes))
+        {
+            return model;
+        }
+        // stale, release it before it gets overwritten
+        model->meshCache = vkfw::MappedFile();
 
-                copyRegion.size = indexBuffer;
-                vkCmdCopyBuffer(commandBuffer, mesh.stagingIndexBuffer.handle, mesh.indexBuffer.handle, 1, &copyRegion);
+        ObjData objData;
+        if (!parseObj(objFile.getData(), objFile.getSize(), threadPool, objData))
+        {
+            return nullptr;
+        }
 
-                model->meshes.emplace_back(mesh);
+        model->parsedMeshes.resize(objData.shapes.size());
+        struct MeshStatistics
+        {
+            VertexCacheStatistics unoptimizedVertexCache;
+            VertexCacheStatistics optimizedVertexCache;
+            OverdrawStatistics unoptimizedOverdraw;
+            OverdrawStatistics optimizedOverdraw;
+            VertexFetchStatistics unoptimizedVertexFetch;
+            VertexFetchStatistics optimizedVertexFetch;
+        };
+        std::vector<MeshStatistics> meshStatistics(objData.shapes.size());
+        threadPool.parallelFor(objData.shapes.size(), [&objData, &model, &meshStatistics, loaderOptions](size_t i)
+                               {
+            auto &mesh = model->parsedMeshes[i];
+            auto &statistics = meshStatistics[i];
+            buildMesh(objData, objData.shapes[i], mesh);
+            statistics.unoptimizedVertexCache = analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+            statistics.unoptimizedVertexFetch = analyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), sizeof(Vertex));
+            if ((loaderOptions & OptimizeOverdraw) != 0)
+            {
+                statistics.unoptimizedOverdraw = analyzeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex));
+            }
+            generateLods(mesh, loaderOptions);
+            optimizeMesh(mesh, loaderOptions);
+            // only the full resolution mesh
+            auto indexCount = mesh.lods[0].indexCount;
+            statistics.optimizedVertexCache = analyzeVertexCache(mesh.indices.data(), indexCount, mesh.vertices.size());
+            statistics.optimizedVertexFetch = analyzeVertexFetch(mesh.indices.data(), indexCount, mesh.vertices.size(), sizeof(Vertex));
+            if ((loaderOptions & OptimizeOverdraw) != 0)
+            {
+                statistics.optimizedOverdraw = analyzeOverdraw(mesh.indices.data(), indexCount, mesh.vertices[0].position, mesh.vertices.size(), sizeof(Vertex));
             }
+            finalizeMesh(mesh, loaderOptions); });
+
+        MeshStatistics total;
+        for (const auto &statistics : meshStatistics)
+        {
+            total.unoptimizedVertexCache += statistics.unoptimizedVertexCache;
+            total.optimizedVertexCache += statistics.optimizedVertexCache;
+            total.unoptimizedOverdraw += statistics.unoptimizedOverdraw;
+            total.optimizedOverdraw += statistics.optimizedOverdraw;
+            total.unoptimizedVertexFetch += statistics.unoptimizedVertexFetch;
+            total.optimizedVertexFetch += statistics.optimizedVertexFetch;
+        }
+        std::cout << "mesh optimization: ACMR " << total.unoptimizedVertexCache.getAcmr() << " -> " << total.optimizedVertexCache.getAcmr()
+                  << ", ATVR " << total.unoptimizedVertexCache.getAtvr() << " -> " << total.optimizedVertexCache.getAtvr()
+                  << ", vertex fetch overfetch " << total.unoptimizedVertexFetch.getOverfetch() << " -> " << total.optimizedVertexFetch.getOverfetch();
+        if ((loaderOptions & OptimizeOverdraw) != 0)
+        {
+            std::cout << ", overdraw " << total.unoptimizedOverdraw.getOverdraw() << " -> " << total.optimizedOverdraw.getOverdraw();
+        }
+        std::cout << std::endl;
+
+        if ((loaderOptions & GenerateLods) != 0)
+        {
+            // triangles per lod level, summed over the meshes that have it
+            std::vector<size_t> lodTriangleCounts(gc_maxLodCount);
+            for (const auto &mesh : model->parsedMeshes)
+            {
+                for (size_t i = 0; i < mesh.lods.size(); ++i)
+                {
+                    lodTriangleCounts[i] += mesh.lods[i].indexCount / 3;
+                }
+            }
+            std::cout << "lods: triangles";
+            for (size_t i = 0; i < gc_maxLodCount && lodTriangleCounts[i] > 0; ++i)
+            {
+                std::cout << (i == 0 ? " " : " / ") << lodTriangleCounts[i];
+            }
+            std::cout << std::endl;
+        }
+
+        for (const auto &mesh : model->parsedMeshes)
+        {
+            // materials aren't loaded
+            MeshCacheMesh meshView{getVertexData(mesh), getVertexCount(mesh), getIndexData(mesh), getIndexCount(mesh), getIndexSize(mesh), mesh.indexRanges.data(), mesh.indexRanges.size(), mesh.meshlets.data(), mesh.meshlets.size(), mesh.lods.data(), mesh.lods.size(), {}, {}, 0, -1};
+            memcpy(meshView.boundsMin, mesh.boundsMin, sizeof(meshView.boundsMin));
+            memcpy(meshView.boundsMax, mesh.boundsMax, sizeof(meshView.boundsMax));
+            meshView.boundingRadius = mesh.boundingRadius;
+            model->meshes.emplace_back(meshView);
         }
 
-        tinyobj_attrib_free(&attributes);
-        tinyobj_shapes_free(shapes, shapeCount);
-        tinyobj_materials_free(materials, materialCount);
+        if (!writeMeshCache(meshCachePath, meshCacheKey, model->meshes))
+        {
+            std::cerr << "couldn't write mesh cache " << meshCachePath << std::endl;
+        }
+
+        return model;
+    }
+
+    // thread-safe, no vulkan calls. every batch of faces is pushed as a separate mesh
+    bool streamModel(vkfw::ThreadPool &threadPool, const std::string &modelPath, uint32_t loaderOptions, MeshStream &meshStream)
+    {
+        return parseObjStream(modelPath, gc_streamWindowSize, gc_streamBatchFaceCount, threadPool, [&meshStream, loaderOptions](const ObjData &batch, bool)
+                              {
+            MeshData mesh;
+            buildMesh(batch, batch.shapes[0], mesh);
+            generateLods(mesh, loaderOptions);
+            optimizeMesh(mesh, loaderOptions);
+            finalizeMesh(mesh, loaderOptions);
+            return meshStream.push(std::move(mesh)); });
+    }
 
-        return std::move(model);
+    inline VkIndexType getIndexType(uint32_t indexSize)
+    {
+        return indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+
+    void getBoundingSphere(const Mesh &mesh, float sphere[4])
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            sphere[i] = (mesh.boundsMin[i] + mesh.boundsMax[i]) * 0.5f;
+        }
+        sphere[3] = mesh.boundingRadius;
+    }
+
+    // the first draw group the mesh's draws (at most drawCount) are compacted into, started anew whenever the mesh can't share the last one.
+    // a mesh with more draws than a group can take spans consecutive groups, all of them full but the last
+    uint32_t addToDrawGroup(Model &model, const Mesh &mesh, uint32_t drawCount, bool quantizedVertices, uint32_t maxGroupDrawCount)
+    {
+        auto meshIndex = (uint32_t)model.meshes.size();
+        if (model.drawGroups.empty() || quantizedVertices || model.drawGroups.back().block != mesh.geometry.block ||
+            model.drawGroups.back().indexType != mesh.indexType || model.drawGroups.back().maxDrawCount + drawCount > maxGroupDrawCount)
+        {
+            model.drawGroups.emplace_back(DrawGroup{mesh.geometry.block, mesh.indexType, meshIndex, model.drawCount, 0});
+        }
+        auto firstDrawGroup = (uint32_t)model.drawGroups.size() - 1;
+        while (drawCount > 0)
+        {
+            if (model.drawGroups.back().maxDrawCount == maxGroupDrawCount)
+            {
+                model.drawGroups.emplace_back(DrawGroup{mesh.geometry.block, mesh.indexType, meshIndex, model.drawCount, 0});
+            }
+            auto groupDrawCount = std::min(drawCount, maxGroupDrawCount - model.drawGroups.back().maxDrawCount);
+            model.drawGroups.back().maxDrawCount += groupDrawCount;
+            model.drawCount += groupDrawCount;
+            drawCount -= groupDrawCount;
+        }
+        return firstDrawGroup;
+    }
+
+    // all meshes are packed into a single arena block, uploaded from a single staging buffer (along with the meshlets or instances, if culled on the gpu)
+    std::unique_ptr<Model> createModel(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::FindMemoryTypeCb &findMemoryTypeCb, const ModelData &modelData, uint32_t loaderOptions, bool gpuCulling, uint32_t maxGroupDrawCount, std::vector<BufferUpload> &uploads)
+    {
+        auto vertexStride = getVertexStride(loaderOptions);
+        auto quantizedVertices = (loaderOptions & QuantizeVertices) != 0;
+        // without meshlets, whole meshes are culled as instances
+        auto cullInstances = gpuCulling && (loaderOptions & BuildMeshlets) == 0;
+
+        VkDeviceSize vertexBufferSize = 0, indexBufferSize = 0;
+        uint32_t meshletCount = 0, drawTemplateCount = 0;
+        for (const auto &meshData : modelData.meshes)
+        {
+            vertexBufferSize += vertexStride * meshData.vertexCount;
+            // the arena aligns every mesh's indices to 4 bytes
+            indexBufferSize += (meshData.indexSize * meshData.indexCount + 3) & ~(VkDeviceSize)3;
+            meshletCount += (uint32_t)meshData.meshletCount;
+            drawTemplateCount += (uint32_t)meshData.indexRangeCount;
+        }
+        VkDeviceSize meshletBufferSize = sizeof(GpuMeshlet) * meshletCount;
+        VkDeviceSize instanceBufferSize = cullInstances ? sizeof(GpuInstance) * modelData.meshes.size() : 0;
+        VkDeviceSize drawTemplateBufferSize = cullInstances ? sizeof(VkDrawIndexedIndirectCommand) * drawTemplateCount : 0;
+
+        auto model = std::make_unique<Model>();
+        model->geometry = std::make_unique<vkfw::GeometryArena>(device, allocCb, findMemoryTypeCb, vertexBufferSize, indexBufferSize);
+        if (modelData.meshes.empty())
+        {
+            return model;
+        }
+        model->stagingBuffer = createBuffer(device, allocCb, findMemoryTypeCb, (size_t)(vertexBufferSize + indexBufferSize + meshletBufferSize + instanceBufferSize + drawTemplateBufferSize), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        if (meshletCount > 0)
+        {
+            model->meshletBuffer = createBuffer(device, allocCb, findMemoryTypeCb, (size_t)meshletBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+        if (cullInstances && drawTemplateCount > 0)
+        {
+            model->instanceBuffer = createBuffer(device, allocCb, findMemoryTypeCb, (size_t)instanceBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+            model->drawTemplateBuffer = createBuffer(device, allocCb, findMemoryTypeCb, (size_t)drawTemplateBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+
+        char *mappedStagingBuffer;
+        vkfwCheckVkResult(vkMapMemory(device, model->stagingBuffer.backingMemory, 0, VK_WHOLE_SIZE, 0, (void **)&mappedStagingBuffer));
+        VkDeviceSize stagingOffset = 0;
+        // after the vertices and indices
+        auto gpuDataOffset = vertexBufferSize + indexBufferSize;
+        auto *gpuMeshlets = reinterpret_cast<GpuMeshlet *>(mappedStagingBuffer + gpuDataOffset);
+        auto *gpuInstances = reinterpret_cast<GpuInstance *>(mappedStagingBuffer + gpuDataOffset + meshletBufferSize);
+        auto *drawTemplates = reinterpret_cast<VkDrawIndexedIndirectCommand *>(mappedStagingBuffer + gpuDataOffset + meshletBufferSize + instanceBufferSize);
+        uint32_t drawTemplateIndex = 0;
+        for (const auto &meshData : modelData.meshes)
+        {
+            auto meshVertexBufferSize = vertexStride * meshData.vertexCount;
+            auto meshIndexBufferSize = meshData.indexSize * meshData.indexCount;
+
+            Mesh mesh{model->geometry->allocate(meshData.vertexCount, vertexStride, meshData.indexCount, meshData.indexSize),
+                      (size_t)meshData.vertexCount,
+                      (size_t)meshData.indexCount};
+            memcpy(mesh.boundsMin, meshData.boundsMin, sizeof(mesh.boundsMin));
+            memcpy(mesh.boundsMax, meshData.boundsMax, sizeof(mesh.boundsMax));
+            mesh.boundingRadius = meshData.boundingRadius;
+            model->meshBounds.add(mesh.boundsMin, mesh.boundsMax, mesh.boundingRadius);
+            mesh.indexType = getIndexType(meshData.indexSize);
+            mesh.indexRanges.assign(meshData.indexRanges, meshData.indexRanges + meshData.indexRangeCount);
+            mesh.firstMeshlet = model->meshletCount;
+            mesh.meshletCount = (uint32_t)meshData.meshletCount;
+            mesh.lods.assign(meshData.lods, meshData.lods + meshData.lodCount);
+
+            // a single lod is drawn per mesh, so a mesh needs as many draws as its biggest lod has meshlets (or index ranges)
+            uint32_t meshDrawCount = 0;
+            for (const auto &lod : mesh.lods)
+            {
+                meshDrawCount = std::max(meshDrawCount, cullInstances ? lod.indexRangeCount : lod.meshletCount);
+            }
+            auto firstDrawGroup = gpuCulling ? addToDrawGroup(*model, mesh, meshDrawCount, quantizedVertices, maxGroupDrawCount) : 0;
+
+            // draws are made relative to the arena block, so that the cull shader can emit them as is.
+            // every meshlet knows the error of its lod and of the next coarser one, so that it can tell whether its lod is the one drawn.
+            // the n-th meshlet of a lod goes to the mesh's n / maxGroupDrawCount-th draw group
+            float lodBounds[4];
+            getBoundingSphere(mesh, lodBounds);
+            for (size_t i = 0; i < mesh.lods.size(); ++i)
+            {
+                const auto &lod = mesh.lods[i];
+                for (auto j = lod.firstMeshlet; j < lod.firstMeshlet + lod.meshletCount; ++j)
+                {
+                    const auto &meshlet = meshData.meshlets[j];
+                    auto &gpuMeshlet = gpuMeshlets[model->meshletCount++];
+                    memcpy(gpuMeshlet.boundingSphere, meshlet.center, sizeof(meshlet.center));
+                    gpuMeshlet.boundingSphere[3] = meshlet.radius;
+                    memcpy(gpuMeshlet.cone, meshlet.coneAxis, sizeof(meshlet.coneAxis));
+                    gpuMeshlet.cone[3] = meshlet.coneCutoff;
+                    memcpy(gpuMeshlet.lodBounds, lodBounds, sizeof(lodBounds));
+                    gpuMeshlet.firstIndex = mesh.geometry.firstIndex + meshlet.firstIndex;
+                    gpuMeshlet.indexCount = meshlet.indexCount;
+                    gpuMeshlet.vertexOffset = (int32_t)(mesh.geometry.vertexOffset + meshlet.baseVertex);
+                    gpuMeshlet.drawGroup = firstDrawGroup + (j - lod.firstMeshlet) / maxGroupDrawCount;
+                    gpuMeshlet.drawOffset = model->drawGroups[gpuMeshlet.drawGroup].firstDraw;
+                    gpuMeshlet.lodError = lod.error;
+                    gpuMeshlet.coarserLodError = i + 1 < mesh.lods.size() ? mesh.lods[i + 1].error : FLT_MAX;
+                    gpuMeshlet.padding = 0;
+                }
+            }
+
+            // instances copy the draw templates of the lod they pick
+            if (cullInstances)
+            {
+                auto &gpuInstance = gpuInstances[model->meshes.size()];
+                memcpy(gpuInstance.boundingSphere, lodBounds, sizeof(lodBounds));
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    gpuInstance.extent[i] = (mesh.boundsMax[i] - mesh.boundsMin[i]) * 0.5f;
+                }
+                gpuInstance.extent[3] = 0;
+                gpuInstance.lodCount = (uint32_t)std::min(mesh.lods.size(), gc_maxLodCount);
+                for (uint32_t i = 0; i < gc_maxLodCount; ++i)
+                {
+                    auto valid = i < gpuInstance.lodCount;
+                    gpuInstance.lodErrors[i] = valid ? mesh.lods[i].error : 0;
+                    gpuInstance.lodFirstDraws[i] = valid ? drawTemplateIndex + mesh.lods[i].firstIndexRange : 0;
+                    gpuInstance.lodDrawCounts[i] = valid ? mesh.lods[i].indexRangeCount : 0;
+                }
+                gpuInstance.drawOffset = model->drawGroups[firstDrawGroup].firstDraw;
+                gpuInstance.drawGroup = firstDrawGroup;
+                gpuInstance.maxGroupDrawCount = maxGroupDrawCount;
+
+                for (const auto &indexRange : mesh.indexRanges)
+                {
+                    drawTemplates[drawTemplateIndex++] = VkDrawIndexedIndirectCommand{indexRange.indexCount, 1, mesh.geometry.firstIndex + indexRange.firstIndex, (int32_t)(mesh.geometry.vertexOffset + indexRange.baseVertex), 0};
+                }
+            }
+
+            // either parsed or mapped straight from the mesh cache, already in the layout the buffers expect
+            memcpy(mappedStagingBuffer + stagingOffset, meshData.vertices, (size_t)meshVertexBufferSize);
+            uploads.emplace_back(BufferUpload{model->stagingBuffer.handle, stagingOffset, model->geometry->getVertexBuffer(mesh.geometry.block), mesh.geometry.vertexBufferOffset, meshVertexBufferSize});
+            stagingOffset += meshVertexBufferSize;
+
+            memcpy(mappedStagingBuffer + stagingOffset, meshData.indices, (size_t)meshIndexBufferSize);
+            uploads.emplace_back(BufferUpload{model->stagingBuffer.handle, stagingOffset, model->geometry->getIndexBuffer(mesh.geometry.block), mesh.geometry.indexBufferOffset, meshIndexBufferSize});
+            stagingOffset += meshIndexBufferSize;
+
+            model->meshes.emplace_back(mesh);
+        }
+        if (meshletCount > 0)
+        {
+            uploads.emplace_back(BufferUpload{model->stagingBuffer.handle, gpuDataOffset, model->meshletBuffer.handle, 0, meshletBufferSize});
+        }
+        if (model->instanceBuffer.handle != VK_NULL_HANDLE)
+        {
+            uploads.emplace_back(BufferUpload{model->stagingBuffer.handle, gpuDataOffset + meshletBufferSize, model->instanceBuffer.handle, 0, instanceBufferSize});
+            uploads.emplace_back(BufferUpload{model->stagingBuffer.handle, gpuDataOffset + meshletBufferSize + instanceBufferSize, model->drawTemplateBuffer.handle, 0, drawTemplateBufferSize});
+        }
+        vkUnmapMemory(device, model->stagingBuffer.backingMemory);
+
+        return model;
+    }
+
+    // pops streamed meshes for as long as they fit in the staging region, which must not be in use by the gpu
+    void uploadStreamedMeshes(MeshStream &meshStream, VkBuffer stagingRing, VkDeviceSize stagingRegionOffset, char *mappedStagingRegion, size_t vertexStride, Model &model, std::vector<BufferUpload> &uploads)
+    {
+        VkDeviceSize stagingOffset = 0;
+        MeshData meshData;
+        while (meshStream.tryPop((size_t)(gc_stagingRegionSize - stagingOffset), meshData))
+        {
+            auto vertexBufferSize = getVertexDataSize(meshData);
+            auto indexBufferSize = getIndexDataSize(meshData);
+
+            Mesh mesh{model.geometry->allocate(getVertexCount(meshData), vertexStride, getIndexCount(meshData), getIndexSize(meshData)),
+                      getVertexCount(meshData),
+                      getIndexCount(meshData)};
+            memcpy(mesh.boundsMin, meshData.boundsMin, sizeof(mesh.boundsMin));
+            memcpy(mesh.boundsMax, meshData.boundsMax, sizeof(mesh.boundsMax));
+            mesh.boundingRadius = meshData.boundingRadius;
+            model.meshBounds.add(mesh.boundsMin, mesh.boundsMax, mesh.boundingRadius);
+            mesh.indexType = getIndexType(getIndexSize(meshData));
+            mesh.indexRanges = std::move(meshData.indexRanges);
+            mesh.lods = std::move(meshData.lods);
+
+            memcpy(mappedStagingRegion + stagingOffset, getVertexData(meshData), vertexBufferSize);
+            uploads.emplace_back(BufferUpload{stagingRing, stagingRegionOffset + stagingOffset, model.geometry->getVertexBuffer(mesh.geometry.block), mesh.geometry.vertexBufferOffset, vertexBufferSize});
+            stagingOffset += vertexBufferSize;
+
+            memcpy(mappedStagingRegion + stagingOffset, getIndexData(meshData), indexBufferSize);
+            uploads.emplace_back(BufferUpload{stagingRing, stagingRegionOffset + stagingOffset, model.geometry->getIndexBuffer(mesh.geometry.block), mesh.geometry.indexBufferOffset, indexBufferSize});
+            stagingOffset += indexBufferSize;
+
+            model.meshes.emplace_back(mesh);
+        }
     }
 
     void setTranslation(float matrix[16], float vector[3])
@@ -573,6 +1137,91 @@ namespace
         matrix[14] = vector[2];
     }
 
+    void multiply(const float a[16], const float b[16], float result[16])
+    {
+        for (uint32_t column = 0; column < 4; ++column)
+        {
+            for (uint32_t row = 0; row < 4; ++row)
+            {
+                result[column * 4 + row] = a[row] * b[column * 4] +
+                                           a[4 + row] * b[column * 4 + 1] +
+                                           a[8 + row] * b[column * 4 + 2] +
+                                           a[12 + row] * b[column * 4 + 3];
+            }
+        }
+    }
+
+    void cross(const float a[3], const float b[3], float result[3])
+    {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    // inverse-transpose of the upper 3x3 block, padded to a mat4 so it can be consumed as such by the shaders
+    // (the cofactor matrix of [c0 c1 c2] is [c1xc2 c2xc0 c0xc1])
+    void setNormalMatrix(float matrix[16], const float modelView[16])
+    {
+        const float *c0 = &modelView[0], *c1 = &modelView[4], *c2 = &modelView[8];
+
+        float cofactors[3][3];
+        cross(c1, c2, cofactors[0]);
+        cross(c2, c0, cofactors[1]);
+        cross(c0, c1, cofactors[2]);
+
+        float determinant = c0[0] * cofactors[0][0] + c0[1] * cofactors[0][1] + c0[2] * cofactors[0][2];
+        float inverseDeterminant = determinant != 0 ? 1 / determinant : 0;
+
+        for (uint32_t column = 0; column < 3; ++column)
+        {
+            for (uint32_t row = 0; row < 3; ++row)
+            {
+                matrix[column * 4 + row] = cofactors[column][row] * inverseDeterminant;
+            }
+            matrix[column * 4 + 3] = 0;
+        }
+        matrix[12] = 0;
+        matrix[13] = 0;
+        matrix[14] = 0;
+        matrix[15] = 1;
+    }
+
+    // the view space origin in the space modelView transforms from (normal holds the inverse-transpose of modelView's upper 3x3 block)
+    void getEye(const float modelView[16], const float normal[16], float eye[3])
+    {
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            eye[i] = -(normal[i * 4] * modelView[12] + normal[i * 4 + 1] * modelView[13] + normal[i * 4 + 2] * modelView[14]);
+        }
+    }
+
+    // pixels covered by a unit length at a unit distance from the eye
+    inline float getProjectionScale(const float projection[16], uint32_t height)
+    {
+        return std::abs(projection[5]) * height * 0.5f;
+    }
+
+    // the coarsest lod whose error covers at most gc_lodErrorThreshold pixels, as seen from the closest point of the mesh bounds.
+    // must match the selection in meshlet_cull.comp
+    size_t selectLod(const Mesh &mesh, const float eye[3], float projectionScale)
+    {
+        float sphere[4];
+        getBoundingSphere(mesh, sphere);
+        float distance = 0;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            distance += (sphere[i] - eye[i]) * (sphere[i] - eye[i]);
+        }
+        distance = std::max(std::sqrt(distance) - sphere[3], 0.0f);
+
+        size_t lod = 0;
+        while (lod + 1 < mesh.lods.size() && mesh.lods[lod + 1].error * projectionScale <= gc_lodErrorThreshold * distance)
+        {
+            ++lod;
+        }
+        return lod;
+    }
+
     void setPerspective(float matrix[16], float fovY, float aspect, float nearClip, float farClip)
     {
         float bottom = nearClip * tanf((fovY * vkfwDegToRad) * 0.5f);
@@ -603,7 +1252,7 @@ namespace
 
     void printUsage()
     {
-        std::cout << "obj_loader <path to obj>" << std::endl;
+        std::cout << "obj_loader [--benchmark-parser | [--stream] [--no-overdraw-optimization] [--quantize-vertices] [--no-index-splitting] [--no-meshlet-culling] [--no-lods] [--no-gpu-culling]] <path to obj>" << std::endl;
     }
 
 }
@@ -614,17 +1263,39 @@ ObjLoaderApplication::~ObjLoaderApplication() = default;
 
 void ObjLoaderApplication::postInitialize()
 {
-    createRenderPass(getDevice(), getAllocationCallbacks(), getSwapChainSurfaceFormat().format, gc_depthStencilFormat, m_renderPass);
-
-    createPipelineLayout(getDevice(), getAllocationCallbacks(), m_pipelineLayout);
-
-    m_vertModule = createShaderModule(getDevice(), getAllocationCallbacks(), vkfw::readFile("spirv/lambert.vert.spv"));
-    m_fragModule = createShaderModule(getDevice(), getAllocationCallbacks(), vkfw::readFile("spirv/lambert.frag.spv"));
-    createGraphicsPipeline(getDevice(), getAllocationCallbacks(), m_vertModule, m_fragModule, m_pipelineLayout.handle, m_renderPass, m_pipeline);
+    vkfw::RenderPassDescription renderPassDescription;
+    auto &colorAttachment = renderPassDescription.colorAttachments[renderPassDescription.colorAttachmentCount++];
+    colorAttachment.format = getSwapChainSurfaceFormat().format;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    // layout transitions happen outside of the render pass, issued by the render graph
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    renderPassDescription.hasDepthStencilAttachment = true;
+    auto &depthStencilAttachment = renderPassDescription.depthStencilAttachment;
+    depthStencilAttachment.format = gc_depthStencilFormat;
+    depthStencilAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    // depth is never read after the render pass
+    depthStencilAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthStencilAttachment.initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthStencilAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    m_renderPass = getRenderPassCache().get(renderPassDescription);
+
+    const VkPushConstantRange pushConstantRanges[] = {vkfw::PushConstants<DrawConstants>::getRange(VK_SHADER_STAGE_VERTEX_BIT)};
+    vkfwCheckResult(vkfw::validatePushConstantRanges(getPhysicalDeviceLimits(), pushConstantRanges, vkfwArraySize(pushConstantRanges)));
+    createPipelineLayout(getDevice(), getAllocationCallbacks(), pushConstantRanges, vkfwArraySize(pushConstantRanges), m_pipelineLayout);
+
+#if defined VKFW_EMBED_SPIRV
+    getShaderRegistry().add(gc_embeddedShaders, vkfwArraySize(gc_embeddedShaders));
+#endif
+    m_vertModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("lambert.vert"));
+    m_fragModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("lambert.frag"));
+    const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
 
-    recreateDepthStencilImageSwapChainImageViewsAndFramebuffers();
+    m_depthStencilAttachments = std::make_unique<vkfw::TransientAttachmentPool>(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, getMaxSimultaneousFrames());
+    recreateDepthStencilAttachmentsAndSwapChainImageViews();
 
-    const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
+    m_renderGraph = std::make_unique<vkfw::RenderGraph>(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, getMaxSimultaneousFrames());
 
     m_sceneConstantBuffers.resize(getMaxSimultaneousFrames());
     for (auto &sceneConstantBuffer : m_sceneConstantBuffers)
@@ -632,7 +1303,7 @@ void ObjLoaderApplication::postInitialize()
         sceneConstantBuffer = createBuffer(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, sizeof(SceneConstants), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     }
 
-    createDescriptorPool(getDevice(), getAllocationCallbacks(), getMaxSimultaneousFrames(), m_descriptorPool);
+    createDescriptorPool(getDevice(), getAllocationCallbacks(), VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, getMaxSimultaneousFrames(), getMaxSimultaneousFrames(), m_descriptorPool);
     m_descriptorSets.resize(getMaxSimultaneousFrames());
     allocateDescriptorSets(getDevice(), m_descriptorPool, m_pipelineLayout.descriptorSetLayout, m_descriptorSets);
 
@@ -657,25 +1328,155 @@ void ObjLoaderApplication::postInitialize()
 
         vkUpdateDescriptorSets(getDevice(), 1, &writeDescriptorSet, 0, nullptr);
     }
+
+    if (getEnabledDeviceFeatures().multiDrawIndirect)
+    {
+        if (isDeviceExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+        {
+            m_drawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(getDevice(), "vkCmdDrawIndexedIndirectCountKHR");
+        }
+
+        const VkPushConstantRange cullPushConstantRanges[] = {vkfw::PushConstants<CullConstants>::getRange(VK_SHADER_STAGE_COMPUTE_BIT)};
+        vkfwCheckResult(vkfw::validatePushConstantRanges(getPhysicalDeviceLimits(), cullPushConstantRanges, vkfwArraySize(cullPushConstantRanges)));
+        createCullPipelineLayout(getDevice(), getAllocationCallbacks(), 3, cullPushConstantRanges, vkfwArraySize(cullPushConstantRanges), m_meshletCullPipelineLayout);
+        m_meshletCullModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("meshlet_cull.comp"));
+        m_meshletCullPipeline = createComputePipeline(getDevice(), getAllocationCallbacks(), getPipelineCache().getHandle(), m_meshletCullPipelineLayout.handle, m_meshletCullModule);
+        createCullPipelineLayout(getDevice(), getAllocationCallbacks(), 4, cullPushConstantRanges, vkfwArraySize(cullPushConstantRanges), m_instanceCullPipelineLayout);
+        m_instanceCullModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("instance_cull.comp"));
+        m_instanceCullPipeline = createComputePipeline(getDevice(), getAllocationCallbacks(), getPipelineCache().getHandle(), m_instanceCullPipelineLayout.handle, m_instanceCullModule);
+
+        // one set of each per frame in flight
+        createDescriptorPool(getDevice(), getAllocationCallbacks(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, (3 + 4) * getMaxSimultaneousFrames(), 2 * getMaxSimultaneousFrames(), m_cullDescriptorPool);
+        m_meshletCullDescriptorSets.resize(getMaxSimultaneousFrames());
+        allocateDescriptorSets(getDevice(), m_cullDescriptorPool, m_meshletCullPipelineLayout.descriptorSetLayout, m_meshletCullDescriptorSets);
+        m_instanceCullDescriptorSets.resize(getMaxSimultaneousFrames());
+        allocateDescriptorSets(getDevice(), m_cullDescriptorPool, m_instanceCullPipelineLayout.descriptorSetLayout, m_instanceCullDescriptorSets);
+    }
 }
 
 bool ObjLoaderApplication::preRun(int argc, char **argv)
 {
+    if (argc > 1 && strcmp(argv[1], "--benchmark-parser") == 0)
+    {
+        if (argc < 3)
+        {
+            printUsage();
+        }
+        else
+        {
+            benchmarkParser(getThreadPool(), argv[2]);
+        }
+        return false;
+    }
+
+    m_loaderOptions = gc_defaultLoaderOptions;
+    auto gpuCulling = true;
+    int modelPathArg = 1;
+    for (; modelPathArg < argc && strncmp(argv[modelPathArg], "--", 2) == 0; ++modelPathArg)
+    {
+        if (strcmp(argv[modelPathArg], "--stream") == 0)
+        {
+            m_streaming = true;
+        }
+        else if (strcmp(argv[modelPathArg], "--no-overdraw-optimization") == 0)
+        {
+            m_loaderOptions &= ~OptimizeOverdraw;
+        }
+        else if (strcmp(argv[modelPathArg], "--quantize-vertices") == 0)
+        {
+            m_loaderOptions |= QuantizeVertices;
+        }
+        else if (strcmp(argv[modelPathArg], "--no-index-splitting") == 0)
+        {
+            m_loaderOptions &= ~SplitIndexRanges;
+        }
+        else if (strcmp(argv[modelPathArg], "--no-meshlet-culling") == 0)
+        {
+            m_loaderOptions &= ~BuildMeshlets;
+        }
+        else if (strcmp(argv[modelPathArg], "--no-lods") == 0)
+        {
+            m_loaderOptions &= ~GenerateLods;
+        }
+        else if (strcmp(argv[modelPathArg], "--no-gpu-culling") == 0)
+        {
+            gpuCulling = false;
+        }
+        else
+        {
+            printUsage();
+            return false;
+        }
+    }
+
 #ifdef _DEBUG
-    if (argc < 2)
+    if (argc <= modelPathArg)
     {
         m_modelPath = "models/bunny.obj";
     }
     else
 #else
-    if (argc < 2)
+    if (argc <= modelPathArg)
     {
         printUsage();
         return false;
     }
 #endif
     {
-        m_modelPath = argv[1];
+        m_modelPath = argv[modelPathArg];
+    }
+
+    // streamed meshes are culled and drawn by the cpu, as they arrive. meshlets are only built if they can be culled
+    m_gpuCulling = gpuCulling && m_meshletCullPipeline != VK_NULL_HANDLE && !m_streaming;
+    if (!m_gpuCulling)
+    {
+        m_loaderOptions &= ~BuildMeshlets;
+    }
+    m_meshletCulling = (m_loaderOptions & BuildMeshlets) != 0;
+
+    // compiled by a worker while the model loads, meshes are skipped until it's ready.
+    // the vertex layout depends on the loader options
+    vkfw::GraphicsPipelineBuilder pipelineBuilder(m_pipelineLayout.handle, m_renderPass);
+    pipelineBuilder.setShaders(m_vertModule, m_fragModule)
+        .setSpecialization(VK_SHADER_STAGE_FRAGMENT_BIT, LambertSpecialization{}, {vkfwSpecializationMapEntry(0, LambertSpecialization, ambient)})
+        .setRasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE)
+        .setDepthTest(true, VK_COMPARE_OP_LESS)
+        .addColorAttachment();
+    if ((m_loaderOptions & QuantizeVertices) != 0)
+    {
+        pipelineBuilder.setSpecialization(VK_SHADER_STAGE_VERTEX_BIT, LambertVertexSpecialization{VK_TRUE}, {vkfwSpecializationMapEntry(0, LambertVertexSpecialization, quantizedVertices)})
+            .addVertexBinding(0, sizeof(QuantizedVertex))
+            .addVertexAttribute(0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(QuantizedVertex, position))
+            .addVertexAttribute(1, 0, VK_FORMAT_R16G16_SNORM, offsetof(QuantizedVertex, normal))
+            .addVertexAttribute(2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(QuantizedVertex, uv));
+    }
+    else
+    {
+        pipelineBuilder.addVertexBinding(0, sizeof(Vertex))
+            .addVertexAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position))
+            .addVertexAttribute(1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, normal))
+            .addVertexAttribute(2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv));
+    }
+    m_pipeline = getPipelineCache().requestAsync(pipelineBuilder.build());
+
+    if (m_streaming)
+    {
+        // meshes are uploaded as soon as they're parsed, through a persistently mapped staging ring
+        const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
+        m_stagingRing = createBuffer(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, (size_t)(gc_stagingRegionSize * getMaxSimultaneousFrames()), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        vkfwCheckVkResult(vkMapMemory(getDevice(), m_stagingRing.backingMemory, 0, VK_WHOLE_SIZE, 0, (void **)&m_mappedStagingRing));
+
+        m_model = std::make_unique<Model>();
+        m_model->geometry = std::make_unique<vkfw::GeometryArena>(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, gc_geometryBlockVertexSize, gc_geometryBlockIndexSize);
+        m_meshStream = std::make_unique<MeshStream>();
+        m_streamResult = getThreadPool().enqueue([this]()
+                                                 { return streamModel(getThreadPool(), m_modelPath, m_loaderOptions, *m_meshStream); });
+    }
+    else
+    {
+        // read and parsed in the background, drawn as soon as it's ready
+        m_modelData = getThreadPool().enqueue([this]()
+                                              { return parseModel(getFileReader(), getThreadPool(), m_modelPath, m_loaderOptions); });
     }
 
     return true;
@@ -683,16 +1484,43 @@ bool ObjLoaderApplication::preRun(int argc, char **argv)
 
 void ObjLoaderApplication::postRun()
 {
+    if (m_modelData.valid())
+    {
+        m_modelData.wait();
+    }
+    if (m_meshStream != nullptr)
+    {
+        m_meshStream->cancel();
+    }
+    if (m_streamResult.valid())
+    {
+        m_streamResult.wait();
+    }
+    m_meshStream = nullptr;
+
+    if (m_stagingRing.handle != VK_NULL_HANDLE)
+    {
+        vkUnmapMemory(getDevice(), m_stagingRing.backingMemory);
+        destroyBuffer(getDevice(), getAllocationCallbacks(), m_stagingRing);
+        m_stagingRing = {};
+        m_mappedStagingRing = nullptr;
+    }
+
+    m_renderGraph = nullptr;
+
     if (m_model != nullptr)
     {
-        for (auto &mesh : m_model->meshes)
+        destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->stagingBuffer);
+        destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->meshletBuffer);
+        destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->instanceBuffer);
+        destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->drawTemplateBuffer);
+        for (uint32_t i = 0; i < m_model->drawCommandBuffers.size(); ++i)
         {
-            destroyBuffer(getDevice(), getAllocationCallbacks(), mesh.vertexBuffer);
-            destroyBuffer(getDevice(), getAllocationCallbacks(), mesh.stagingVertexBuffer);
-            destroyBuffer(getDevice(), getAllocationCallbacks(), mesh.indexBuffer);
-            destroyBuffer(getDevice(), getAllocationCallbacks(), mesh.stagingIndexBuffer);
+            destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->drawCommandBuffers[i]);
+            destroyBuffer(getDevice(), getAllocationCallbacks(), m_model->drawCountBuffers[i]);
         }
-        m_model->meshes.clear();
+        // the arena frees its blocks on destruction
+        m_model = nullptr;
     }
 
     for (auto &sceneConstantBuffer : m_sceneConstantBuffers)
@@ -701,20 +1529,20 @@ void ObjLoaderApplication::postRun()
     }
     m_sceneConstantBuffers.clear();
 
-    destroyDepthStencilImageSwapChainImageViewsAndFramebuffers();
+    destroyDepthStencilAttachmentsAndSwapChainImageViews();
+    m_depthStencilAttachments = nullptr;
 
-    if (m_pipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(getDevice(), m_pipeline, getAllocationCallbacks());
-        m_pipeline = VK_NULL_HANDLE;
-    }
+    // pipelines are owned by the pipeline cache
+    m_pipeline = {};
     if (m_fragModule != VK_NULL_HANDLE)
     {
+        getPipelineCache().evictShaderModule(m_fragModule);
         vkDestroyShaderModule(getDevice(), m_fragModule, getAllocationCallbacks());
         m_fragModule = VK_NULL_HANDLE;
     }
     if (m_vertModule != VK_NULL_HANDLE)
     {
+        getPipelineCache().evictShaderModule(m_vertModule);
         vkDestroyShaderModule(getDevice(), m_vertModule, getAllocationCallbacks());
         m_vertModule = VK_NULL_HANDLE;
     }
@@ -722,126 +1550,434 @@ void ObjLoaderApplication::postRun()
     {
         vkDestroyDescriptorPool(getDevice(), m_descriptorPool, getAllocationCallbacks());
     }
+    if (m_meshletCullPipeline != VK_NULL_HANDLE)
+    {
+        vkDestroyPipeline(getDevice(), m_meshletCullPipeline, getAllocationCallbacks());
+        vkDestroyShaderModule(getDevice(), m_meshletCullModule, getAllocationCallbacks());
+        vkDestroyPipelineLayout(getDevice(), m_meshletCullPipelineLayout.handle, getAllocationCallbacks());
+        vkDestroyDescriptorSetLayout(getDevice(), m_meshletCullPipelineLayout.descriptorSetLayout, getAllocationCallbacks());
+        vkDestroyPipeline(getDevice(), m_instanceCullPipeline, getAllocationCallbacks());
+        vkDestroyShaderModule(getDevice(), m_instanceCullModule, getAllocationCallbacks());
+        vkDestroyPipelineLayout(getDevice(), m_instanceCullPipelineLayout.handle, getAllocationCallbacks());
+        vkDestroyDescriptorSetLayout(getDevice(), m_instanceCullPipelineLayout.descriptorSetLayout, getAllocationCallbacks());
+        vkDestroyDescriptorPool(getDevice(), m_cullDescriptorPool, getAllocationCallbacks());
+        m_meshletCullPipeline = VK_NULL_HANDLE;
+        m_meshletCullModule = VK_NULL_HANDLE;
+        m_meshletCullPipelineLayout = {};
+        m_instanceCullPipeline = VK_NULL_HANDLE;
+        m_instanceCullModule = VK_NULL_HANDLE;
+        m_instanceCullPipelineLayout = {};
+        m_cullDescriptorPool = VK_NULL_HANDLE;
+    }
+    getPipelineCache().evictPipelineLayout(m_pipelineLayout.handle);
     vkDestroyPipelineLayout(getDevice(), m_pipelineLayout.handle, getAllocationCallbacks());
     vkDestroyDescriptorSetLayout(getDevice(), m_pipelineLayout.descriptorSetLayout, getAllocationCallbacks());
     m_pipelineLayout = {};
-    if (m_renderPass != VK_NULL_HANDLE)
-    {
-        vkDestroyRenderPass(getDevice(), m_renderPass, getAllocationCallbacks());
-        m_renderPass = VK_NULL_HANDLE;
-    }
+    m_renderPass = VK_NULL_HANDLE;
 }
 
 void ObjLoaderApplication::postResize(uint32_t width, uint32_t height)
 {
-    recreateDepthStencilImageSwapChainImageViewsAndFramebuffers();
+    recreateDepthStencilAttachmentsAndSwapChainImageViews();
 }
 
 void ObjLoaderApplication::update()
 {
     setTranslation(m_sceneConstants.view, m_cameraPosition);
     setPerspective(m_sceneConstants.projection, 60, getWidth() / (float)getHeight(), 0.1f, 100);
+
+    float modelView[16];
+    multiply(m_sceneConstants.view, m_drawConstants.model, modelView);
+    setNormalMatrix(m_drawConstants.normal, modelView);
 }
 
 void ObjLoaderApplication::record(VkCommandBuffer commandBuffer)
 {
     copyToMappedMemory<SceneConstants>(getDevice(), getAllocationCallbacks(), m_sceneConstantBuffers[getCurrentFrame()].backingMemory, {m_sceneConstants});
 
-    if (m_model == nullptr)
+    // meshes from firstNewMesh on are uploaded this frame, arena blocks from firstNewBlock on are created this frame
+    auto firstNewMesh = m_model != nullptr ? m_model->meshes.size() : 0;
+    auto firstNewBlock = m_model != nullptr ? m_model->geometry->getBlockCount() : 0;
+    std::vector<BufferUpload> uploads;
+    bool usesStagingBuffer = false;
+    if (m_model == nullptr && m_modelData.valid() && m_modelData.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
     {
+        auto modelData = m_modelData.get();
+        if (modelData == nullptr)
+        {
+            vkfw::fail("failed to load %s", m_modelPath.c_str());
+        }
+
         const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
+        m_model = createModel(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, *modelData, m_loaderOptions, m_gpuCulling, getPhysicalDeviceLimits().maxDrawIndirectCount, uploads);
+        usesStagingBuffer = !uploads.empty();
+        if (m_model->drawCount > 0)
+        {
+            createDrawBuffers();
+        }
+    }
+    if (m_streamResult.valid() && m_streamResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !m_streamResult.get())
+    {
+        vkfw::fail("failed to stream %s", m_modelPath.c_str());
+    }
+    bool usesStagingRing = false;
+    if (m_meshStream != nullptr)
+    {
+        // the frame's fence has been waited on, so its staging region is free
+        auto stagingRegionOffset = gc_stagingRegionSize * getCurrentFrame();
+        auto uploadCount = uploads.size();
+        uploadStreamedMeshes(*m_meshStream, m_stagingRing.handle, stagingRegionOffset, m_mappedStagingRing + stagingRegionOffset, getVertexStride(m_loaderOptions), *m_model, uploads);
+        usesStagingRing = uploads.size() > uploadCount;
+    }
+    // until the model is loaded, frames are just cleared
+    const auto blockCount = m_model != nullptr ? m_model->geometry->getBlockCount() : 0;
+    const auto gpuCulling = m_model != nullptr && !m_model->drawCommandBuffers.empty();
+
+    m_renderGraph->reset();
 
-        if ((m_model = loadModel(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, commandBuffer, m_modelPath)) == nullptr)
+    m_renderGraph->importImage("swapChain", getSwapChainImage(getSwapChainIndex()), m_swapChainImageViews[getSwapChainIndex()], VK_IMAGE_ASPECT_COLOR_BIT, vkfw::ResourceUsage::SwapChainAcquire, vkfw::ResourceUsage::Present);
+    // depth is cleared every frame, so its previous contents (and layout) are discarded: the graph transitions it from undefined before the lambert pass.
+    // that also covers the pool's freshly (re)created images, which nothing else transitions (and which lazily allocated memory only backs once used)
+    m_renderGraph->importImage("depthStencil", m_depthStencilAttachments->getImage(getCurrentFrame()), m_depthStencilAttachments->getImageView(getCurrentFrame()), VK_IMAGE_ASPECT_DEPTH_BIT, vkfw::ResourceUsage::Undefined, vkfw::ResourceUsage::Undefined);
+
+    // arena blocks outlive the frame, so they're imported with the usage they're left in
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+        auto newBlock = i >= firstNewBlock;
+        m_renderGraph->importBuffer("vertexBuffer" + std::to_string(i), m_model->geometry->getVertexBuffer(i), newBlock ? vkfw::ResourceUsage::Undefined : vkfw::ResourceUsage::VertexBuffer, vkfw::ResourceUsage::VertexBuffer);
+        m_renderGraph->importBuffer("indexBuffer" + std::to_string(i), m_model->geometry->getIndexBuffer(i), newBlock ? vkfw::ResourceUsage::Undefined : vkfw::ResourceUsage::IndexBuffer, vkfw::ResourceUsage::IndexBuffer);
+    }
+    if (gpuCulling)
+    {
+        auto initialUsage = usesStagingBuffer ? vkfw::ResourceUsage::Undefined : vkfw::ResourceUsage::StorageByComputeShader;
+        if (m_meshletCulling)
         {
-            vkfw::fail("failed to load %s", m_modelPath.c_str());
+            m_renderGraph->importBuffer("meshlets", m_model->meshletBuffer.handle, initialUsage, vkfw::ResourceUsage::StorageByComputeShader);
         }
+        else
+        {
+            m_renderGraph->importBuffer("instances", m_model->instanceBuffer.handle, initialUsage, vkfw::ResourceUsage::StorageByComputeShader);
+            m_renderGraph->importBuffer("drawTemplates", m_model->drawTemplateBuffer.handle, initialUsage, vkfw::ResourceUsage::StorageByComputeShader);
+        }
+        // rewritten every frame
+        m_renderGraph->importBuffer("drawCommands", m_model->drawCommandBuffers[getCurrentFrame()].handle, vkfw::ResourceUsage::Undefined, vkfw::ResourceUsage::IndirectBuffer);
+        m_renderGraph->importBuffer("drawCounts", m_model->drawCountBuffers[getCurrentFrame()].handle, vkfw::ResourceUsage::Undefined, vkfw::ResourceUsage::IndirectBuffer);
+    }
 
-        VkImageMemoryBarrier imageMemoryBarrier;
-        imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        imageMemoryBarrier.pNext = nullptr;
-        imageMemoryBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
-        imageMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
-        imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-        imageMemoryBarrier.srcQueueFamilyIndex = getGraphicsQueueFamilyIndex();
-        imageMemoryBarrier.dstQueueFamilyIndex = getPresentQueueFamilyIndex();
-        imageMemoryBarrier.image = getSwapChainImage(getSwapChainIndex());
-        imageMemoryBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (!uploads.empty())
+    {
+        if (usesStagingBuffer)
+        {
+            m_renderGraph->importBuffer("stagingBuffer", m_model->stagingBuffer.handle, vkfw::ResourceUsage::Undefined, vkfw::ResourceUsage::Undefined);
+        }
+        if (usesStagingRing)
+        {
+            m_renderGraph->importBuffer("stagingRing", m_stagingRing.handle, vkfw::ResourceUsage::Undefined, vkfw::ResourceUsage::Undefined);
+        }
 
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        auto uploadPass = m_renderGraph->addPass("upload", [uploads](VkCommandBuffer commandBuffer, const vkfw::RenderGraph &)
+                                                 {
+                                                     for (const auto &upload : uploads)
+                                                     {
+                                                         VkBufferCopy copyRegion{upload.sourceOffset, upload.destinationOffset, upload.size};
+                                                         vkCmdCopyBuffer(commandBuffer, upload.source, upload.destination, 1, &copyRegion);
+                                                     }
+                                                 });
+        // streamed meshes can also be appended to the last older block
+        for (auto i = m_model->meshes[firstNewMesh].geometry.block; i < blockCount; ++i)
+        {
+            uploadPass.write("vertexBuffer" + std::to_string(i), vkfw::ResourceUsage::TransferDestination)
+                .write("indexBuffer" + std::to_string(i), vkfw::ResourceUsage::TransferDestination);
+        }
+        if (usesStagingBuffer)
+        {
+            uploadPass.read("stagingBuffer", vkfw::ResourceUsage::TransferSource);
+        }
+        if (usesStagingBuffer && gpuCulling && m_meshletCulling)
+        {
+            uploadPass.write("meshlets", vkfw::ResourceUsage::TransferDestination);
+        }
+        if (usesStagingBuffer && gpuCulling && !m_meshletCulling)
+        {
+            uploadPass.write("instances", vkfw::ResourceUsage::TransferDestination)
+                .write("drawTemplates", vkfw::ResourceUsage::TransferDestination);
+        }
+        if (usesStagingRing)
+        {
+            uploadPass.read("stagingRing", vkfw::ResourceUsage::TransferSource);
+        }
     }
-    else
+
+    // culling and lod selection happen in object space (the mesh and meshlet bounds aren't quantized)
+    float modelView[16], normal[16], clip[16], eye[3];
+    multiply(m_sceneConstants.view, m_drawConstants.model, modelView);
+    multiply(m_sceneConstants.projection, modelView, clip);
+    setNormalMatrix(normal, modelView);
+    getEye(modelView, normal, eye);
+    auto frustum = vkfw::extractFrustum(clip);
+    auto projectionScale = getProjectionScale(m_sceneConstants.projection, getHeight());
+
+    // meshes outside of the frustum aren't drawn at all (the cpu only goes through the meshes if they aren't culled on the gpu)
+    if (m_model != nullptr && !gpuCulling)
     {
-        const VkDeviceSize offsets[] = {0};
+        m_model->meshVisibility.resize(m_model->meshes.size());
+        m_model->meshBounds.cull(frustum, m_model->meshVisibility.data(), &getThreadPool());
+    }
 
-        beginRenderPass(commandBuffer, m_renderPass, getWidth(), getHeight(), m_framebuffers[getSwapChainIndex()]);
+    if (gpuCulling)
+    {
+        // without draw counts, every draw slot is drawn, so the ones left unwritten must be empty draws
+        auto clearDrawCommands = m_drawIndexedIndirectCount == nullptr;
+        auto clearPass = m_renderGraph->addPass("clearDraws", [clearDrawCommands](VkCommandBuffer commandBuffer, const vkfw::RenderGraph &renderGraph)
+                                                {
+                                                    vkCmdFillBuffer(commandBuffer, renderGraph.getBuffer("drawCounts"), 0, VK_WHOLE_SIZE, 0);
+                                                    if (clearDrawCommands)
+                                                    {
+                                                        vkCmdFillBuffer(commandBuffer, renderGraph.getBuffer("drawCommands"), 0, VK_WHOLE_SIZE, 0);
+                                                    }
+                                                });
+        clearPass.write("drawCounts", vkfw::ResourceUsage::TransferDestination);
+        if (clearDrawCommands)
+        {
+            clearPass.write("drawCommands", vkfw::ResourceUsage::TransferDestination);
+        }
 
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+        CullConstants cullConstants;
+        memcpy(cullConstants.frustumPlanes, frustum.planes, sizeof(frustum.planes));
+        memcpy(cullConstants.eye, eye, sizeof(eye));
+        cullConstants.objectCount = m_meshletCulling ? m_model->meshletCount : (uint32_t)m_model->meshes.size();
+        cullConstants.projectionScale = projectionScale;
+        cullConstants.lodErrorThreshold = gc_lodErrorThreshold;
+
+        // a single dispatch, however many meshes there are
+        auto pipeline = m_meshletCulling ? m_meshletCullPipeline : m_instanceCullPipeline;
+        auto pipelineLayout = m_meshletCulling ? m_meshletCullPipelineLayout.handle : m_instanceCullPipelineLayout.handle;
+        auto descriptorSet = m_meshletCulling ? m_meshletCullDescriptorSets[getCurrentFrame()] : m_instanceCullDescriptorSets[getCurrentFrame()];
+        auto groupSize = m_meshletCulling ? gc_meshletCullGroupSize : gc_instanceCullGroupSize;
+        auto cullPass = m_renderGraph->addPass(m_meshletCulling ? "meshletCulling" : "instanceCulling", [cullConstants, pipeline, pipelineLayout, descriptorSet, groupSize](VkCommandBuffer commandBuffer, const vkfw::RenderGraph &)
+                                               {
+                                                   vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+                                                   vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+                                                   vkfw::PushConstants<CullConstants>::push(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, cullConstants);
+                                                   vkCmdDispatch(commandBuffer, (cullConstants.objectCount + groupSize - 1) / groupSize, 1, 1);
+                                               });
+        if (m_meshletCulling)
+        {
+            cullPass.read("meshlets", vkfw::ResourceUsage::StorageByComputeShader);
+        }
+        else
+        {
+            cullPass.read("instances", vkfw::ResourceUsage::StorageByComputeShader)
+                .read("drawTemplates", vkfw::ResourceUsage::StorageByComputeShader);
+        }
+        cullPass.read("drawCounts", vkfw::ResourceUsage::StorageByComputeShader)
+            .write("drawCounts", vkfw::ResourceUsage::StorageByComputeShader)
+            .write("drawCommands", vkfw::ResourceUsage::StorageByComputeShader);
+    }
 
-        VkViewport viewport{0, 0, (float)getWidth(), (float)getHeight(), 0, 1};
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    auto lambertPass = m_renderGraph->addPass("lambert", [this, eye, projectionScale](VkCommandBuffer commandBuffer, const vkfw::RenderGraph &renderGraph)
+                                              {
+                                                  const VkDeviceSize offsets[] = {0};
+
+                                                  vkfw::FramebufferDescription framebufferDescription;
+                                                  framebufferDescription.renderPass = m_renderPass;
+                                                  framebufferDescription.attachments[framebufferDescription.attachmentCount++] = renderGraph.getImageView("swapChain");
+                                                  framebufferDescription.attachments[framebufferDescription.attachmentCount++] = renderGraph.getImageView("depthStencil");
+                                                  framebufferDescription.width = getWidth();
+                                                  framebufferDescription.height = getHeight();
+
+                                                  beginRenderPass(commandBuffer, m_renderPass, getWidth(), getHeight(), getFramebufferCache().get(framebufferDescription));
+
+                                                  auto pipeline = m_pipeline.get();
+                                                  if (pipeline == VK_NULL_HANDLE || m_model == nullptr)
+                                                  {
+                                                      vkCmdEndRenderPass(commandBuffer);
+                                                      return;
+                                                  }
+
+                                                  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+                                                  VkViewport viewport{0, 0, (float)getWidth(), (float)getHeight(), 0, 1};
+                                                  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+                                                  VkRect2D scissorRect{0, 0, getWidth(), getHeight()};
+                                                  vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+
+                                                  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout.handle, 0, 1, &m_descriptorSets[getCurrentFrame()], 0, nullptr);
+
+                                                  // meshes are allocated in block order, so buffers are only rebound when crossing into the next block
+                                                  // (or, for the index buffer, when the index type changes)
+                                                  auto boundBlock = UINT32_MAX;
+                                                  auto boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+                                                  auto bindGeometry = [this, commandBuffer, &offsets, &boundBlock, &boundIndexType](uint32_t block, VkIndexType indexType)
+                                                  {
+                                                      if (block != boundBlock)
+                                                      {
+                                                          auto vertexBuffer = m_model->geometry->getVertexBuffer(block);
+                                                          vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, offsets);
+                                                          boundIndexType = VK_INDEX_TYPE_MAX_ENUM;
+                                                      }
+                                                      if (block != boundBlock || indexType != boundIndexType)
+                                                      {
+                                                          vkCmdBindIndexBuffer(commandBuffer, m_model->geometry->getIndexBuffer(block), 0, indexType);
+                                                          boundBlock = block;
+                                                          boundIndexType = indexType;
+                                                      }
+                                                  };
+                                                  // quantized meshes have their own dequantization
+                                                  auto quantizedVertices = (m_loaderOptions & QuantizeVertices) != 0;
+                                                  auto pushDequantizedDrawConstants = [this, commandBuffer](const Mesh &mesh)
+                                                  {
+                                                      auto drawConstants = m_drawConstants;
+                                                      float dequantization[16];
+                                                      setDequantization(dequantization, mesh.boundsMin, mesh.boundsMax);
+                                                      multiply(m_drawConstants.model, dequantization, drawConstants.model);
+                                                      vkfw::PushConstants<DrawConstants>::push(commandBuffer, m_pipelineLayout.handle, VK_SHADER_STAGE_VERTEX_BIT, drawConstants);
+                                                  };
+                                                  if (!quantizedVertices)
+                                                  {
+                                                      vkfw::PushConstants<DrawConstants>::push(commandBuffer, m_pipelineLayout.handle, VK_SHADER_STAGE_VERTEX_BIT, m_drawConstants);
+                                                  }
+
+                                                  // culled on the gpu: one indirect draw per draw group (none bigger than maxDrawIndirectCount), the cpu never goes through the meshes
+                                                  if (!m_model->drawCommandBuffers.empty())
+                                                  {
+                                                      auto drawCommands = renderGraph.getBuffer("drawCommands");
+                                                      auto drawCounts = renderGraph.getBuffer("drawCounts");
+                                                      for (uint32_t i = 0; i < m_model->drawGroups.size(); ++i)
+                                                      {
+                                                          const auto &drawGroup = m_model->drawGroups[i];
+                                                          if (quantizedVertices)
+                                                          {
+                                                              pushDequantizedDrawConstants(m_model->meshes[drawGroup.firstMesh]);
+                                                          }
+                                                          bindGeometry(drawGroup.block, drawGroup.indexType);
+                                                          if (m_drawIndexedIndirectCount != nullptr)
+                                                          {
+                                                              m_drawIndexedIndirectCount(commandBuffer, drawCommands, drawGroup.firstDraw * sizeof(VkDrawIndexedIndirectCommand), drawCounts, i * sizeof(uint32_t), drawGroup.maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+                                                          }
+                                                          else
+                                                          {
+                                                              vkCmdDrawIndexedIndirect(commandBuffer, drawCommands, drawGroup.firstDraw * sizeof(VkDrawIndexedIndirectCommand), drawGroup.maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+                                                          }
+                                                      }
+                                                      vkCmdEndRenderPass(commandBuffer);
+                                                      return;
+                                                  }
+
+                                                  for (size_t i = 0; i < m_model->meshes.size(); ++i)
+                                                  {
+                                                      if (!m_model->meshVisibility[i])
+                                                      {
+                                                          continue;
+                                                      }
+                                                      const auto &mesh = m_model->meshes[i];
+                                                      if (quantizedVertices)
+                                                      {
+                                                          pushDequantizedDrawConstants(mesh);
+                                                      }
+                                                      bindGeometry(mesh.geometry.block, mesh.indexType);
+                                                      const auto &lod = mesh.lods[selectLod(mesh, eye, projectionScale)];
+                                                      for (auto i = lod.firstIndexRange; i < lod.firstIndexRange + lod.indexRangeCount; ++i)
+                                                      {
+                                                          const auto &indexRange = mesh.indexRanges[i];
+                                                          vkCmdDrawIndexed(commandBuffer, indexRange.indexCount, 1, mesh.geometry.firstIndex + indexRange.firstIndex, (int32_t)(mesh.geometry.vertexOffset + indexRange.baseVertex), 0);
+                                                      }
+                                                  }
+
+                                                  vkCmdEndRenderPass(commandBuffer);
+                                              });
+    for (uint32_t i = 0; i < blockCount; ++i)
+    {
+        lambertPass.read("vertexBuffer" + std::to_string(i), vkfw::ResourceUsage::VertexBuffer)
+            .read("indexBuffer" + std::to_string(i), vkfw::ResourceUsage::IndexBuffer);
+    }
+    if (gpuCulling)
+    {
+        lambertPass.read("drawCommands", vkfw::ResourceUsage::IndirectBuffer)
+            .read("drawCounts", vkfw::ResourceUsage::IndirectBuffer);
+    }
+    lambertPass.write("swapChain", vkfw::ResourceUsage::ColorAttachment)
+        .write("depthStencil", vkfw::ResourceUsage::DepthStencilAttachment);
 
-        VkRect2D scissorRect{0, 0, getWidth(), getHeight()};
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+    m_renderGraph->compile();
+    m_renderGraph->execute(commandBuffer, getCurrentFrame());
+}
 
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout.handle, 0, 1, &m_descriptorSets[getCurrentFrame()], 0, nullptr);
+void ObjLoaderApplication::createDrawBuffers()
+{
+    const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
+    m_model->drawCommandBuffers.resize(getMaxSimultaneousFrames());
+    m_model->drawCountBuffers.resize(getMaxSimultaneousFrames());
+    for (uint32_t i = 0; i < getMaxSimultaneousFrames(); ++i)
+    {
+        // as many draws as all the draw groups can take, and a draw count per group
+        m_model->drawCommandBuffers[i] = createBuffer(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, sizeof(VkDrawIndexedIndirectCommand) * m_model->drawCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_model->drawCountBuffers[i] = createBuffer(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, sizeof(uint32_t) * m_model->drawGroups.size(), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-        for (const auto &mesh : m_model->meshes)
+        // in binding order
+        std::vector<VkBuffer> buffers;
+        if (m_meshletCulling)
+        {
+            buffers = {m_model->meshletBuffer.handle, m_model->drawCommandBuffers[i].handle, m_model->drawCountBuffers[i].handle};
+        }
+        else
+        {
+            buffers = {m_model->instanceBuffer.handle, m_model->drawTemplateBuffer.handle, m_model->drawCommandBuffers[i].handle, m_model->drawCountBuffers[i].handle};
+        }
+        auto descriptorSet = m_meshletCulling ? m_meshletCullDescriptorSets[i] : m_instanceCullDescriptorSets[i];
+        std::vector<VkDescriptorBufferInfo> descriptorBufferInfos(buffers.size());
+        std::vector<VkWriteDescriptorSet> writeDescriptorSets(buffers.size());
+        for (uint32_t j = 0; j < buffers.size(); ++j)
         {
-            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer.handle, offsets);
-            vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer.handle, 0, VK_INDEX_TYPE_UINT32);
-            vkCmdDrawIndexed(commandBuffer, (uint32_t)mesh.indexCount, 1, 0, 0, 0);
+            descriptorBufferInfos[j].buffer = buffers[j];
+            descriptorBufferInfos[j].offset = 0;
+            descriptorBufferInfos[j].range = VK_WHOLE_SIZE;
+
+            writeDescriptorSets[j].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptorSets[j].pNext = nullptr;
+            writeDescriptorSets[j].dstSet = descriptorSet;
+            writeDescriptorSets[j].dstBinding = j;
+            writeDescriptorSets[j].dstArrayElement = 0;
+            writeDescriptorSets[j].descriptorCount = 1;
+            writeDescriptorSets[j].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writeDescriptorSets[j].pBufferInfo = &descriptorBufferInfos[j];
+            writeDescriptorSets[j].pImageInfo = nullptr;
+            writeDescriptorSets[j].pTexelBufferView = nullptr;
         }
 
-        vkCmdEndRenderPass(commandBuffer);
+        vkUpdateDescriptorSets(getDevice(), (uint32_t)writeDescriptorSets.size(), writeDescriptorSets.data(), 0, nullptr);
     }
 }
 
-void ObjLoaderApplication::recreateDepthStencilImageSwapChainImageViewsAndFramebuffers()
+void ObjLoaderApplication::recreateDepthStencilAttachmentsAndSwapChainImageViews()
 {
-    destroyDepthStencilImageSwapChainImageViewsAndFramebuffers();
+    destroyDepthStencilAttachmentsAndSwapChainImageViews();
 
-    const auto findMemoryTypeCb = std::bind(&ObjLoaderApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2);
+    // depth is only needed while a frame is in flight, so there's one per frame instead of one per swapchain image
+    m_depthStencilAttachments->recreate(gc_depthStencilFormat, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, getWidth(), getHeight());
 
-    m_depthStencilImages.resize(getSwapChainCount());
-    m_depthStencilImageViews.resize(getSwapChainCount());
     m_swapChainImageViews.resize(getSwapChainCount());
-    m_framebuffers.resize(getSwapChainCount());
     for (uint32_t i = 0; i < getSwapChainCount(); ++i)
     {
-        m_depthStencilImages[i] = createImage(getDevice(), getAllocationCallbacks(), findMemoryTypeCb, gc_depthStencilFormat, getWidth(), getHeight(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-        createImageView(getDevice(), getAllocationCallbacks(), gc_depthStencilFormat, m_depthStencilImages[i].handle, VK_IMAGE_ASPECT_DEPTH_BIT, m_depthStencilImageViews[i]);
         createImageView(getDevice(), getAllocationCallbacks(), getSwapChainSurfaceFormat().format, getSwapChainImage(i), VK_IMAGE_ASPECT_COLOR_BIT, m_swapChainImageViews[i]);
-        createFramebuffer(getDevice(), getAllocationCallbacks(), m_renderPass, m_swapChainImageViews[i], m_depthStencilImageViews[i], getWidth(), getHeight(), m_framebuffers[i]);
     }
 }
 
-void ObjLoaderApplication::destroyDepthStencilImageSwapChainImageViewsAndFramebuffers()
+void ObjLoaderApplication::destroyDepthStencilAttachmentsAndSwapChainImageViews()
 {
-    for (auto &framebuffer : m_framebuffers)
-    {
-        vkDestroyFramebuffer(getDevice(), framebuffer, getAllocationCallbacks());
-    }
-    m_framebuffers.clear();
-
     for (auto &swapChainImageView : m_swapChainImageViews)
     {
+        getFramebufferCache().evictImageView(swapChainImageView);
         vkDestroyImageView(getDevice(), swapChainImageView, getAllocationCallbacks());
     }
     m_swapChainImageViews.clear();
 
-    for (auto &depthStencilImage : m_depthStencilImages)
-    {
-        vkDestroyImage(getDevice(), depthStencilImage.handle, getAllocationCallbacks());
-        vkFreeMemory(getDevice(), depthStencilImage.backingMemory, getAllocationCallbacks());
-    }
-    m_depthStencilImages.clear();
-
-    for (auto &depthStencilImageView : m_depthStencilImageViews)
+    for (uint32_t i = 0; i < m_depthStencilAttachments->getCount(); ++i)
     {
-        vkDestroyImageView(getDevice(), depthStencilImageView, getAllocationCallbacks());
+        getFramebufferCache().evictImageView(m_depthStencilAttachments->getImageView(i));
     }
-    m_depthStencilImageViews.clear();
+    m_depthStencilAttachments->destroy();
 }
 
 void ObjLoaderApplication::keyDown(uint32_t keyCode)
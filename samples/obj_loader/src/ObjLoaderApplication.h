@@ -1,9 +1,14 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <vkfw/Application.h>
+#include <vkfw/RenderGraph.h>
+#include <vkfw/TransientAttachmentPool.h>
 
+#include <future>
 #include <memory>
 
 struct Model;
+struct ModelData;
+struct MeshStream;
 
 struct Buffer
 {
@@ -11,12 +16,6 @@ struct Buffer
     VkDeviceMemory backingMemory{VK_NULL_HANDLE};
 };
 
-struct Image
-{
-    VkImage handle{VK_NULL_HANDLE};
-    VkDeviceMemory backingMemory{VK_NULL_HANDLE};
-};
-
 struct PipelineLayout
 {
     VkPipelineLayout handle{VK_NULL_HANDLE};
@@ -32,6 +31,26 @@ struct SceneConstants
     float projection[16];
 };
 
+struct DrawConstants
+{
+    float model[16]{1, 0, 0, 0,
+                    0, 1, 0, 0,
+                    0, 0, 1, 0,
+                    0, 0, 0, 1};
+    float normal[16];
+};
+
+// matches uCullConstants in meshlet_cull.comp and instance_cull.comp
+struct CullConstants
+{
+    float frustumPlanes[24];
+    float eye[3];
+    // meshlets or instances
+    uint32_t objectCount;
+    float projectionScale;
+    float lodErrorThreshold;
+};
+
 class ObjLoaderApplication : public vkfw::Application
 {
 public:
@@ -48,23 +67,45 @@ protected:
     void keyDown(uint32_t keyCode) override;
 
 private:
-    void recreateDepthStencilImageSwapChainImageViewsAndFramebuffers();
-    void destroyDepthStencilImageSwapChainImageViewsAndFramebuffers();
+    void recreateDepthStencilAttachmentsAndSwapChainImageViews();
+    void destroyDepthStencilAttachmentsAndSwapChainImageViews();
+    void createDrawBuffers();
 
     VkShaderModule m_vertModule{VK_NULL_HANDLE};
     VkShaderModule m_fragModule{VK_NULL_HANDLE};
     VkRenderPass m_renderPass{VK_NULL_HANDLE};
     PipelineLayout m_pipelineLayout;
-    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    vkfw::PipelineHandle m_pipeline;
     std::vector<VkImageView> m_swapChainImageViews;
-    std::vector<Image> m_depthStencilImages;
-    std::vector<VkImageView> m_depthStencilImageViews;
-    std::vector<VkFramebuffer> m_framebuffers;
+    std::unique_ptr<vkfw::TransientAttachmentPool> m_depthStencilAttachments;
     std::vector<Buffer> m_sceneConstantBuffers;
     SceneConstants m_sceneConstants{};
+    DrawConstants m_drawConstants{};
     VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
     std::vector<VkDescriptorSet> m_descriptorSets;
+    // gpu culling (of meshlets, or of whole meshes as instances) is only available with multi-draw indirect
+    VkShaderModule m_meshletCullModule{VK_NULL_HANDLE};
+    PipelineLayout m_meshletCullPipelineLayout;
+    VkPipeline m_meshletCullPipeline{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_meshletCullDescriptorSets;
+    VkShaderModule m_instanceCullModule{VK_NULL_HANDLE};
+    PipelineLayout m_instanceCullPipelineLayout;
+    VkPipeline m_instanceCullPipeline{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_instanceCullDescriptorSets;
+    VkDescriptorPool m_cullDescriptorPool{VK_NULL_HANDLE};
+    // null without VK_KHR_draw_indirect_count, then every draw slot is drawn (culled ones are left zeroed)
+    PFN_vkCmdDrawIndexedIndirectCountKHR m_drawIndexedIndirectCount{nullptr};
+    bool m_gpuCulling{false};
+    bool m_meshletCulling{false};
     std::string m_modelPath;
+    std::future<std::unique_ptr<ModelData>> m_modelData;
+    bool m_streaming{false};
+    uint32_t m_loaderOptions{0};
+    std::unique_ptr<MeshStream> m_meshStream;
+    std::future<bool> m_streamResult;
+    Buffer m_stagingRing;
+    char *m_mappedStagingRing{nullptr};
     std::unique_ptr<Model> m_model{nullptr};
+    std::unique_ptr<vkfw::RenderGraph> m_renderGraph;
     float m_cameraPosition[3]{0, 0, -1};
 };
\ No newline at end of file
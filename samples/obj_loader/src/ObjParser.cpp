@@ -0,0 +1,701 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define OBJPARSER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // big enough to amortize the per-chunk overhead, small enough to balance the load
+    constexpr size_t gc_minChunkSize = 1 << 20;
+    constexpr uint32_t gc_chunksPerThread = 4;
+
+    enum IndexComponent
+    {
+        Position,
+        Normal,
+        Uv
+    };
+
+    // corner whose index is relative to the chunk start, fixed up once the chunk's offsets are known
+    struct RelativeIndex
+    {
+        uint32_t corner;
+        uint32_t component;
+    };
+
+    struct ObjChunk
+    {
+        const char *begin;
+        const char *end;
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        std::vector<ObjIndex> indices;
+        std::vector<RelativeIndex> relativeIndices;
+        // face offsets are relative to the chunk start
+        std::vector<ObjShape> shapes;
+        bool failed{false};
+        size_t positionOffset{0};
+        size_t normalOffset{0};
+        size_t uvOffset{0};
+        size_t faceOffset{0};
+    };
+
+    struct FaceCorner
+    {
+        ObjIndex index;
+        // one bit per IndexComponent
+        uint32_t relativeComponents;
+    };
+
+    inline bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // fields are walked bytewise on purpose: they are a few bytes long, a number's end already falls out of
+    // scanning its digits, and masking a block of separators per line (like findLineEnd does for '\n')
+    // measured 8-20% slower than this loop
+    inline const char *skipSpaces(const char *it, const char *end)
+    {
+        while (it != end && isSpace(*it))
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    inline uint32_t countTrailingZeros(uint32_t mask)
+    {
+#if defined _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (uint32_t)index;
+#else
+        return (uint32_t)__builtin_ctz(mask);
+#endif
+    }
+
+    // compares a whole block of bytes against '\n' at a time, the remainder is scanned bytewise
+    inline const char *findLineEnd(const char *it, const char *end)
+    {
+#if defined __AVX2__
+        const auto newLines = _mm256_set1_epi8('\n');
+        for (; end - it >= 32; it += 32)
+        {
+            auto mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(it)), newLines));
+            if (mask != 0)
+            {
+                return it + countTrailingZeros(mask);
+            }
+        }
+#elif defined OBJPARSER_SSE2
+        const auto newLines = _mm_set1_epi8('\n');
+        for (; end - it >= 16; it += 16)
+        {
+            auto mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(it)), newLines));
+            if (mask != 0)
+            {
+                return it + countTrailingZeros(mask);
+            }
+        }
+#endif
+        while (it != end && *it != '\n')
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    // powers of ten that are exact in a float
+    const float gc_powersOf10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    constexpr int32_t gc_maxExactExponent = 10;
+    constexpr uint32_t gc_maxExactMantissa = 1u << 24;
+
+    // clinger's fast path: when the decimal mantissa and the power of ten are both exact floats,
+    // a single (correctly rounded) multiplication or division gives the correctly rounded result.
+    // anything else (too many significant digits, big exponents, inf/nan) is left to the slow path
+    bool parseFloatFast(const char *&it, const char *end, float &value)
+    {
+#if FLT_EVAL_METHOD != 0
+        // intermediate results with extra precision would round twice
+        (void)it;
+        (void)end;
+        (void)value;
+        return false;
+#else
+        auto *numberIt = it;
+        bool negative = false;
+        if (numberIt != end && (*numberIt == '-' || *numberIt == '+'))
+        {
+            negative = *numberIt++ == '-';
+        }
+
+        uint32_t mantissa = 0;
+        int32_t exponent = 0;
+        uint32_t digitCount = 0;
+        for (; numberIt != end && *numberIt >= '0' && *numberIt <= '9'; ++numberIt, ++digitCount)
+        {
+            mantissa = mantissa * 10 + (*numberIt - '0');
+            if (mantissa > gc_maxExactMantissa)
+            {
+                return false;
+            }
+        }
+        if (numberIt != end && *numberIt == '.')
+        {
+            ++numberIt;
+            for (; numberIt != end && *numberIt >= '0' && *numberIt <= '9'; ++numberIt, ++digitCount)
+            {
+                mantissa = mantissa * 10 + (*numberIt - '0');
+                if (mantissa > gc_maxExactMantissa)
+                {
+                    return false;
+                }
+                --exponent;
+            }
+        }
+        if (digitCount == 0)
+        {
+            return false;
+        }
+        if (numberIt != end && (*numberIt == 'e' || *numberIt == 'E'))
+        {
+            ++numberIt;
+            bool negativeExponent = false;
+            if (numberIt != end && (*numberIt == '-' || *numberIt == '+'))
+            {
+                negativeExponent = *numberIt++ == '-';
+            }
+            if (numberIt == end || *numberIt < '0' || *numberIt > '9')
+            {
+                return false;
+            }
+            int32_t explicitExponent = 0;
+            for (; numberIt != end && *numberIt >= '0' && *numberIt <= '9'; ++numberIt)
+            {
+                explicitExponent = explicitExponent * 10 + (*numberIt - '0');
+                if (explicitExponent > 100)
+                {
+                    return false;
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+        if (numberIt != end && !isSpace(*numberIt) && *numberIt != '\n')
+        {
+            return false;
+        }
+
+        if (exponent < -gc_maxExactExponent || exponent > gc_maxExactExponent)
+        {
+            return false;
+        }
+        value = exponent < 0 ? (float)mantissa / gc_powersOf10[-exponent] : (float)mantissa * gc_powersOf10[exponent];
+        value = negative ? -value : value;
+        it = numberIt;
+        return true;
+#endif
+    }
+
+    bool parseFloat(const char *&it, const char *end, float &value)
+    {
+        it = skipSpaces(it, end);
+        if (parseFloatFast(it, end, value))
+        {
+            return true;
+        }
+        // strtof needs a terminated string and the buffer might be a mapping that ends right at the last digit
+        char token[64];
+        size_t length = 0;
+        while (it != end && !isSpace(*it) && *it != '\n' && length < sizeof(token) - 1)
+        {
+            token[length++] = *it++;
+        }
+        // a token that doesn't fit is rejected like any other malformed one, instead of being cut short (parsing would resume mid-token)
+        if (length == 0 || (it != end && !isSpace(*it) && *it != '\n'))
+        {
+            return false;
+        }
+        token[length] = '\0';
+        char *tokenEnd;
+        value = strtof(token, &tokenEnd);
+        return tokenEnd == token + length;
+    }
+
+    bool parseInt(const char *&it, const char *end, int32_t &value)
+    {
+        bool negative = false;
+        if (it != end && (*it == '-' || *it == '+'))
+        {
+            negative = *it++ == '-';
+        }
+        if (it == end || *it < '0' || *it > '9')
+        {
+            return false;
+        }
+        int64_t result = 0;
+        while (it != end && *it >= '0' && *it <= '9')
+        {
+            result = result * 10 + (*it++ - '0');
+            if (result > INT32_MAX)
+            {
+                return false;
+            }
+        }
+        value = (int32_t)(negative ? -result : result);
+        return true;
+    }
+
+    // 1-based indices become 0-based, negative ones are resolved against the number of elements seen so far in the chunk
+    bool resolveIndex(int32_t index, size_t localCount, IndexComponent component, FaceCorner &corner, int32_t &resolvedIndex)
+    {
+        if (index > 0)
+        {
+            resolvedIndex = index - 1;
+        }
+        else if (index < 0)
+        {
+            resolvedIndex = (int32_t)localCount + index;
+            corner.relativeComponents |= 1u << component;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // v, v/vt, v//vn or v/vt/vn
+    bool parseFaceCorner(const char *&it, const char *end, const ObjChunk &chunk, FaceCorner &corner)
+    {
+        corner = {{gc_objMissingIndex, gc_objMissingIndex, gc_objMissingIndex}, 0};
+        int32_t index;
+        if (!parseInt(it, end, index) || !resolveIndex(index, chunk.positions.size() / 3, Position, corner, corner.index.position))
+        {
+            return false;
+        }
+        if (it == end || *it != '/')
+        {
+            return true;
+        }
+        ++it;
+        if (it != end && *it != '/')
+        {
+            if (!parseInt(it, end, index) || !resolveIndex(index, chunk.uvs.size() / 2, Uv, corner, corner.index.uv))
+            {
+                return false;
+            }
+        }
+        if (it == end || *it != '/')
+        {
+            return true;
+        }
+        ++it;
+        return parseInt(it, end, index) && resolveIndex(index, chunk.normals.size() / 3, Normal, corner, corner.index.normal);
+    }
+
+    void emitCorner(const FaceCorner &corner, ObjChunk &chunk)
+    {
+        auto cornerIndex = (uint32_t)chunk.indices.size();
+        chunk.indices.emplace_back(corner.index);
+        for (uint32_t component = Position; component <= Uv; ++component)
+        {
+            if ((corner.relativeComponents & (1u << component)) != 0)
+            {
+                chunk.relativeIndices.emplace_back(RelativeIndex{cornerIndex, component});
+            }
+        }
+    }
+
+    bool parseFloats(const char *it, const char *end, uint32_t count, std::vector<float> &values)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            float value;
+            if (!parseFloat(it, end, value))
+            {
+                return false;
+            }
+            values.emplace_back(value);
+        }
+        // anything else (w, vertex colors) is ignored
+        return true;
+    }
+
+    void parseChunk(ObjChunk &chunk)
+    {
+        std::vector<FaceCorner> face;
+        auto *it = chunk.begin;
+        while (it != chunk.end)
+        {
+            auto *lineEnd = findLineEnd(it, chunk.end);
+            auto *lineBegin = skipSpaces(it, lineEnd);
+            it = lineEnd != chunk.end ? lineEnd + 1 : lineEnd;
+
+            if (lineEnd - lineBegin < 2)
+            {
+                continue;
+            }
+
+            // comments and unknown commands are skipped
+            bool succeeded = true;
+            bool twoLetterCommand = lineEnd - lineBegin > 2 && isSpace(lineBegin[2]);
+            if (lineBegin[0] == 'v' && isSpace(lineBegin[1]))
+            {
+                succeeded = parseFloats(lineBegin + 2, lineEnd, 3, chunk.positions);
+            }
+            else if (lineBegin[0] == 'v' && lineBegin[1] == 'n' && twoLetterCommand)
+            {
+                succeeded = parseFloats(lineBegin + 3, lineEnd, 3, chunk.normals);
+            }
+            else if (lineBegin[0] == 'v' && lineBegin[1] == 't' && twoLetterCommand)
+            {
+                succeeded = parseFloats(lineBegin + 3, lineEnd, 2, chunk.uvs);
+            }
+            else if (lineBegin[0] == 'f' && isSpace(lineBegin[1]))
+            {
+                face.clear();
+                auto *cornerIt = skipSpaces(lineBegin + 2, lineEnd);
+                while (cornerIt != lineEnd && succeeded)
+                {
+                    FaceCorner corner;
+                    succeeded = parseFaceCorner(cornerIt, lineEnd, chunk, corner);
+                    face.emplace_back(corner);
+                    cornerIt = skipSpaces(cornerIt, lineEnd);
+                }
+                succeeded = succeeded && face.size() >= 3;
+                if (succeeded)
+                {
+                    for (size_t i = 1; i + 1 < face.size(); ++i)
+                    {
+                        emitCorner(face[0], chunk);
+                        emitCorner(face[i], chunk);
+                        emitCorner(face[i + 1], chunk);
+                    }
+                }
+            }
+            else if ((lineBegin[0] == 'g' || lineBegin[0] == 'o') && isSpace(lineBegin[1]))
+            {
+                auto *nameBegin = skipSpaces(lineBegin + 2, lineEnd);
+                auto *nameEnd = lineEnd;
+                while (nameEnd != nameBegin && isSpace(nameEnd[-1]))
+                {
+                    --nameEnd;
+                }
+                chunk.shapes.emplace_back(ObjShape{std::string(nameBegin, nameEnd), chunk.indices.size() / 3, 0});
+            }
+
+            if (!succeeded)
+            {
+                chunk.failed = true;
+                return;
+            }
+        }
+    }
+
+    std::vector<ObjChunk> splitIntoChunks(const char *data, size_t size, uint32_t threadCount)
+    {
+        auto chunkCount = std::max<size_t>(std::min<size_t>(threadCount * gc_chunksPerThread, size / gc_minChunkSize), 1);
+        auto chunkSize = size / chunkCount;
+        std::vector<ObjChunk> chunks;
+        chunks.reserve(chunkCount);
+        auto *end = data + size;
+        auto *it = data;
+        while (it != end)
+        {
+            auto *chunkEnd = it + std::min<size_t>(chunkSize, end - it);
+            // chunks always end right after a line break (or at the end of the buffer)
+            chunkEnd = findLineEnd(chunkEnd, end);
+            if (chunkEnd != end)
+            {
+                ++chunkEnd;
+            }
+            chunks.emplace_back();
+            chunks.back().begin = it;
+            chunks.back().end = chunkEnd;
+            it = chunkEnd;
+        }
+        return chunks;
+    }
+
+    inline bool isValidIndex(int32_t index, size_t count)
+    {
+        return index == gc_objMissingIndex || (index >= 0 && (size_t)index < count);
+    }
+
+    // the chunk's attribute offsets have to be set
+    void resolveRelativeIndices(ObjChunk &chunk)
+    {
+        for (const auto &relativeIndex : chunk.relativeIndices)
+        {
+            auto &index = chunk.indices[relativeIndex.corner];
+            switch (relativeIndex.component)
+            {
+            case Position:
+                index.position += (int32_t)chunk.positionOffset;
+                break;
+            case Normal:
+                index.normal += (int32_t)chunk.normalOffset;
+                break;
+            case Uv:
+                index.uv += (int32_t)chunk.uvOffset;
+                break;
+            }
+        }
+    }
+
+    bool validateIndices(const ObjChunk &chunk, size_t positionCount, size_t normalCount, size_t uvCount)
+    {
+        for (const auto &index : chunk.indices)
+        {
+            if (!isValidIndex(index.position, positionCount) || !isValidIndex(index.normal, normalCount) || !isValidIndex(index.uv, uvCount))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // shapes only start with a g/o line, so faces before the first one go to an unnamed shape.
+    // a g/o line that follows another one without faces in between only renames the shape
+    void mergeShapes(const std::vector<ObjChunk> &chunks, size_t faceCount, std::vector<ObjShape> &shapes)
+    {
+        shapes.emplace_back(ObjShape{"", 0, 0});
+        for (const auto &chunk : chunks)
+        {
+            for (const auto &chunkShape : chunk.shapes)
+            {
+                auto faceOffset = chunk.faceOffset + chunkShape.faceOffset;
+                if (shapes.back().faceOffset == faceOffset)
+                {
+                    shapes.back().name = chunkShape.name;
+                }
+                else
+                {
+                    shapes.emplace_back(ObjShape{chunkShape.name, faceOffset, 0});
+                }
+            }
+        }
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            auto nextFaceOffset = i + 1 < shapes.size() ? shapes[i + 1].faceOffset : faceCount;
+            shapes[i].faceCount = nextFaceOffset - shapes[i].faceOffset;
+        }
+        shapes.erase(std::remove_if(shapes.begin(), shapes.end(), [](const ObjShape &shape)
+                                    { return shape.faceCount == 0; }),
+                     shapes.end());
+    }
+
+
+    // accumulates the attributes of consecutive chunks and hands their faces over in batches, one shape at a time
+    class ObjStream
+    {
+    public:
+        ObjStream(size_t batchFaceCount, const ObjBatchCb &batchCb) : m_batchFaceCount(batchFaceCount), m_batchCb(batchCb)
+        {
+            m_batch.shapes.emplace_back(ObjShape{"", 0, 0});
+        }
+
+        bool add(ObjChunk &chunk)
+        {
+            chunk.positionOffset = m_batch.positions.size() / 3;
+            chunk.normalOffset = m_batch.normals.size() / 3;
+            chunk.uvOffset = m_batch.uvs.size() / 2;
+            m_batch.positions.insert(m_batch.positions.end(), chunk.positions.begin(), chunk.positions.end());
+            m_batch.normals.insert(m_batch.normals.end(), chunk.normals.begin(), chunk.normals.end());
+            m_batch.uvs.insert(m_batch.uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+
+            resolveRelativeIndices(chunk);
+            if (!validateIndices(chunk, m_batch.positions.size() / 3, m_batch.normals.size() / 3, m_batch.uvs.size() / 2))
+            {
+                return false;
+            }
+
+            size_t face = 0;
+            for (const auto &chunkShape : chunk.shapes)
+            {
+                if (!addFaces(chunk, face, chunkShape.faceOffset))
+                {
+                    return false;
+                }
+                face = chunkShape.faceOffset;
+                // same rules as mergeShapes
+                if (m_shapeFaceCount > 0 && !flush(true))
+                {
+                    return false;
+                }
+                m_batch.shapes[0].name = chunkShape.name;
+                m_shapeFaceCount = 0;
+            }
+            return addFaces(chunk, face, chunk.indices.size() / 3);
+        }
+
+        bool finish()
+        {
+            return m_shapeFaceCount == 0 || flush(true);
+        }
+
+    private:
+        // a full batch is only flushed once more faces come, so that the last batch of a shape is always flagged as such
+        bool addFaces(const ObjChunk &chunk, size_t begin, size_t end)
+        {
+            while (begin < end)
+            {
+                if (m_batch.indices.size() == m_batchFaceCount * 3 && !flush(false))
+                {
+                    return false;
+                }
+                auto count = std::min(end - begin, m_batchFaceCount - m_batch.indices.size() / 3);
+                m_batch.indices.insert(m_batch.indices.end(), chunk.indices.begin() + begin * 3, chunk.indices.begin() + (begin + count) * 3);
+                m_shapeFaceCount += count;
+                begin += count;
+            }
+            return true;
+        }
+
+        bool flush(bool lastBatchOfShape)
+        {
+            m_batch.shapes[0].faceCount = m_batch.indices.size() / 3;
+            auto succeeded = m_batchCb(m_batch, lastBatchOfShape);
+            m_batch.indices.clear();
+            return succeeded;
+        }
+
+        size_t m_batchFaceCount;
+        const ObjBatchCb &m_batchCb;
+        ObjData m_batch;
+        size_t m_shapeFaceCount{0};
+    };
+
+}
+
+bool parseObj(const char *data, size_t size, vkfw::ThreadPool &threadPool, ObjData &objData)
+{
+    objData = {};
+    if (data == nullptr || size == 0)
+    {
+        return false;
+    }
+
+    auto chunks = splitIntoChunks(data, size, threadPool.getThreadCount() + 1);
+
+    threadPool.parallelFor(chunks.size(), [&chunks](size_t i)
+                           { parseChunk(chunks[i]); });
+
+    // prefix sums
+    size_t positionCount = 0, normalCount = 0, uvCount = 0, faceCount = 0;
+    for (auto &chunk : chunks)
+    {
+        if (chunk.failed)
+        {
+            return false;
+        }
+        chunk.positionOffset = positionCount;
+        chunk.normalOffset = normalCount;
+        chunk.uvOffset = uvCount;
+        chunk.faceOffset = faceCount;
+        positionCount += chunk.positions.size() / 3;
+        normalCount += chunk.normals.size() / 3;
+        uvCount += chunk.uvs.size() / 2;
+        faceCount += chunk.indices.size() / 3;
+    }
+
+    objData.positions.resize(positionCount * 3);
+    objData.normals.resize(normalCount * 3);
+    objData.uvs.resize(uvCount * 2);
+    objData.indices.resize(faceCount * 3);
+
+    threadPool.parallelFor(chunks.size(), [&chunks, &objData, positionCount, normalCount, uvCount](size_t i)
+                           {
+        auto &chunk = chunks[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), objData.positions.begin() + chunk.positionOffset * 3);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), objData.normals.begin() + chunk.normalOffset * 3);
+        std::copy(chunk.uvs.begin(), chunk.uvs.end(), objData.uvs.begin() + chunk.uvOffset * 2);
+
+        resolveRelativeIndices(chunk);
+        if (!validateIndices(chunk, positionCount, normalCount, uvCount))
+        {
+            chunk.failed = true;
+            return;
+        }
+        std::copy(chunk.indices.begin(), chunk.indices.end(), objData.indices.begin() + chunk.faceOffset * 3); });
+
+    for (const auto &chunk : chunks)
+    {
+        if (chunk.failed)
+        {
+            return false;
+        }
+    }
+
+    mergeShapes(chunks, faceCount, objData.shapes);
+
+    return true;
+}
+
+bool parseObjStream(const std::string &filename, size_t windowSize, size_t batchFaceCount, vkfw::ThreadPool &threadPool, const ObjBatchCb &batchCb)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open() || windowSize == 0 || batchFaceCount == 0)
+    {
+        return false;
+    }
+
+    ObjStream stream(batchFaceCount, batchCb);
+    std::vector<char> window(windowSize);
+    size_t carriedSize = 0;
+    bool endOfFile = false;
+    while (!endOfFile)
+    {
+        // a single line that doesn't fit in the window
+        if (carriedSize == window.size())
+        {
+            window.resize(window.size() * 2);
+        }
+
+        file.read(window.data() + carriedSize, (std::streamsize)(window.size() - carriedSize));
+        endOfFile = !file;
+        auto *begin = window.data();
+        auto *end = begin + carriedSize + (size_t)file.gcount();
+
+        // only whole lines are parsed, the last partial one is carried over to the next window
+        auto *parseEnd = end;
+        if (!endOfFile)
+        {
+            while (parseEnd != begin && parseEnd[-1] != '\n')
+            {
+                --parseEnd;
+            }
+        }
+
+        if (parseEnd != begin)
+        {
+            auto chunks = splitIntoChunks(begin, parseEnd - begin, threadPool.getThreadCount() + 1);
+            threadPool.parallelFor(chunks.size(), [&chunks](size_t i)
+                                   { parseChunk(chunks[i]); });
+            for (auto &chunk : chunks)
+            {
+                if (chunk.failed || !stream.add(chunk))
+                {
+                    return false;
+                }
+            }
+        }
+
+        carriedSize = end - parseEnd;
+        memmove(begin, parseEnd, carriedSize);
+    }
+
+    return stream.finish();
+}
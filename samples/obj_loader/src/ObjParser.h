@@ -0,0 +1,54 @@
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+#include <vkfw/ThreadPool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// same value tinyobj uses for a missing index (ie.: the normal in "f 1/2")
+constexpr int32_t gc_objMissingIndex = INT32_MIN;
+
+// 0-based, relative (negative) indices already resolved
+struct ObjIndex
+{
+    int32_t position;
+    int32_t normal;
+    int32_t uv;
+};
+
+// faces are triangles (polygons are fan-triangulated)
+struct ObjShape
+{
+    std::string name;
+    size_t faceOffset;
+    size_t faceCount;
+};
+
+struct ObjData
+{
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> uvs;
+    // 3 per face
+    std::vector<ObjIndex> indices;
+    std::vector<ObjShape> shapes;
+};
+
+// splits the buffer into line-aligned chunks, parses them concurrently and merges the results using prefix sums.
+// only geometry is parsed (v, vt, vn, f, g and o), materials are ignored
+bool parseObj(const char *data, size_t size, vkfw::ThreadPool &threadPool, ObjData &objData);
+
+// batch holds every attribute parsed so far, but only the faces of the batch and the single shape they belong to.
+// it's only valid during the call. returning false stops the parsing
+using ObjBatchCb = std::function<bool(const ObjData &batch, bool lastBatchOfShape)>;
+
+// reads the file in windows of windowSize bytes (parsed like parseObj) and hands faces over in batches of at most batchFaceCount,
+// so faces are never all in memory at once (attributes are, since any face can reference them).
+// unlike parseObj, faces can only reference attributes that come before them in the file
+bool parseObjStream(const std::string &filename, size_t windowSize, size_t batchFaceCount, vkfw::ThreadPool &threadPool, const ObjBatchCb &batchCb);
+
+#endif
@@ -0,0 +1,119 @@
+#include "ParserBenchmark.h"
+#include "ObjParser.h"
+
+#define TINYOBJ_LOADER_C_IMPLEMENTATION
+#include "tinyobj_loader_c.h"
+
+#include <vkfw/MappedFile.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace
+{
+    constexpr uint32_t gc_benchmarkIterations = 5;
+
+    struct BenchmarkContext
+    {
+        const vkfw::MappedFile *objFile;
+    };
+
+    // serves the obj from memory, so that only parsing is measured. materials aren't loaded
+    void readFileCallback(void *ctx, const char *, int is_mtl, const char *, char **buf, size_t *len)
+    {
+        auto *benchmarkContext = static_cast<BenchmarkContext *>(ctx);
+        if (is_mtl)
+        {
+            *buf = nullptr;
+            *len = 0;
+            return;
+        }
+        *buf = const_cast<char *>(benchmarkContext->objFile->getData());
+        *len = benchmarkContext->objFile->getSize();
+    }
+
+    // best of gc_benchmarkIterations, in seconds
+    double measure(const std::function<bool()> &parse)
+    {
+        double bestTime = 0;
+        for (uint32_t i = 0; i < gc_benchmarkIterations; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (!parse())
+            {
+                return 0;
+            }
+            auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            bestTime = i == 0 ? time : std::min(bestTime, time);
+        }
+        return bestTime;
+    }
+
+    void printThroughput(const char *name, size_t size, double time)
+    {
+        if (time == 0)
+        {
+            std::cout << name << ": failed" << std::endl;
+            return;
+        }
+        std::cout << name << ": " << (size / (1024.0 * 1024.0)) / time << " MB/s (" << time * 1000 << " ms)" << std::endl;
+    }
+
+}
+
+bool benchmarkParser(vkfw::ThreadPool &threadPool, const std::string &path)
+{
+    vkfw::MappedFile objFile(path);
+    if (objFile.getData() == nullptr)
+    {
+        std::cout << "couldn't read " << path << std::endl;
+        return false;
+    }
+
+    // page the whole file in, so that the first run doesn't pay for I/O
+    volatile char sum = 0;
+    for (size_t i = 0; i < objFile.getSize(); i += 4096)
+    {
+        sum += objFile.getData()[i];
+    }
+
+    auto tinyobjTime = measure([&objFile, &path]()
+                               {
+        tinyobj_attrib_t attributes;
+        tinyobj_shape_t *shapes;
+        tinyobj_material_t *materials;
+        size_t shapeCount, materialCount;
+        BenchmarkContext benchmarkContext{&objFile};
+        auto result = tinyobj_parse_obj(&attributes, &shapes, &shapeCount, &materials, &materialCount, path.c_str(), &readFileCallback, &benchmarkContext, TINYOBJ_FLAG_TRIANGULATE);
+        if (result != TINYOBJ_SUCCESS)
+        {
+            return false;
+        }
+        tinyobj_attrib_free(&attributes);
+        tinyobj_shapes_free(shapes, shapeCount);
+        tinyobj_materials_free(materials, materialCount);
+        return true; });
+
+    // no workers, so parallelFor runs everything on this thread
+    vkfw::ThreadPool serialThreadPool(0);
+    auto serialTime = measure([&objFile, &serialThreadPool]()
+                              {
+        ObjData objData;
+        return parseObj(objFile.getData(), objFile.getSize(), serialThreadPool, objData); });
+
+    auto parallelTime = measure([&objFile, &threadPool]()
+                                {
+        ObjData objData;
+        return parseObj(objFile.getData(), objFile.getSize(), threadPool, objData); });
+
+    std::cout << path << " (" << objFile.getSize() / (1024.0 * 1024.0) << " MB)" << std::endl;
+    printThroughput("tinyobj", objFile.getSize(), tinyobjTime);
+    printThroughput("ObjParser (1 thread)", objFile.getSize(), serialTime);
+    auto parallelName = "ObjParser (" + std::to_string(threadPool.getThreadCount() + 1) + " threads)";
+    printThroughput(parallelName.c_str(), objFile.getSize(), parallelTime);
+
+    return true;
+}
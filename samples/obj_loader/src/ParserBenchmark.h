@@ -0,0 +1,11 @@
+#ifndef PARSERBENCHMARK_H
+#define PARSERBENCHMARK_H
+
+#include <vkfw/ThreadPool.h>
+
+#include <string>
+
+// prints the throughput (MB/s) of tinyobj and of ObjParser (serial and parallel) parsing the same file
+bool benchmarkParser(vkfw::ThreadPool &threadPool, const std::string &path);
+
+#endif
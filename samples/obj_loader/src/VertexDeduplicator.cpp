@@ -0,0 +1,86 @@
+#include "VertexDeduplicator.h"
+
+namespace
+{
+    constexpr uint32_t gc_emptySlot = ~0u;
+    constexpr size_t gc_minSlotCount = 64;
+
+    inline size_t getHash(const VertexKey &key)
+    {
+        // murmur3 finalizer over a multiplicative mix of the three indices
+        uint32_t hash = (uint32_t)key.position * 0x9e3779b1u ^ (uint32_t)key.normal * 0x85ebca77u ^ (uint32_t)key.uv * 0xc2b2ae3du;
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+
+    inline bool operator==(const VertexKey &a, const VertexKey &b)
+    {
+        return a.position == b.position && a.normal == b.normal && a.uv == b.uv;
+    }
+
+    size_t getSlotCount(size_t vertexCount)
+    {
+        // keep the load factor under 1/2
+        size_t slotCount = gc_minSlotCount;
+        while (slotCount < vertexCount * 2)
+        {
+            slotCount <<= 1;
+        }
+        return slotCount;
+    }
+
+}
+
+VertexDeduplicator::VertexDeduplicator(size_t expectedVertexCount)
+{
+    rehash(getSlotCount(expectedVertexCount));
+}
+
+std::pair<uint32_t, bool> VertexDeduplicator::insert(const VertexKey &key)
+{
+    auto slotIndex = getHash(key) & m_mask;
+    while (true)
+    {
+        auto &slot = m_slots[slotIndex];
+        if (slot.index == gc_emptySlot)
+        {
+            slot.key = key;
+            slot.index = m_vertexCount++;
+            auto index = slot.index;
+            if ((size_t)m_vertexCount * 2 > m_slots.size())
+            {
+                rehash(m_slots.size() * 2);
+            }
+            return {index, true};
+        }
+        if (slot.key == key)
+        {
+            return {slot.index, false};
+        }
+        slotIndex = (slotIndex + 1) & m_mask;
+    }
+}
+
+void VertexDeduplicator::rehash(size_t slotCount)
+{
+    std::vector<Slot> slots(slotCount, Slot{{0, 0, 0}, gc_emptySlot});
+    m_mask = slotCount - 1;
+    for (const auto &slot : m_slots)
+    {
+        if (slot.index == gc_emptySlot)
+        {
+            continue;
+        }
+        auto slotIndex = getHash(slot.key) & m_mask;
+        while (slots[slotIndex].index != gc_emptySlot)
+        {
+            slotIndex = (slotIndex + 1) & m_mask;
+        }
+        slots[slotIndex] = slot;
+    }
+    m_slots = std::move(slots);
+}
@@ -0,0 +1,46 @@
+#ifndef VERTEXDEDUPLICATOR_H
+#define VERTEXDEDUPLICATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// OBJ corners reference positions, normals and uvs independently
+struct VertexKey
+{
+    int32_t position;
+    int32_t normal;
+    int32_t uv;
+};
+
+// maps VertexKeys to compact vertex indices.
+// open addressing with linear probing over 16-byte slots (4 per cache line), so most lookups touch a single line
+class VertexDeduplicator
+{
+public:
+    explicit VertexDeduplicator(size_t expectedVertexCount = 0);
+
+    // the index of the vertex with that key, and whether it was just added
+    std::pair<uint32_t, bool> insert(const VertexKey &key);
+
+    inline uint32_t getVertexCount() const
+    {
+        return m_vertexCount;
+    }
+
+private:
+    struct Slot
+    {
+        VertexKey key;
+        uint32_t index;
+    };
+
+    void rehash(size_t slotCount);
+
+    std::vector<Slot> m_slots;
+    size_t m_mask{0};
+    uint32_t m_vertexCount{0};
+};
+
+#endif
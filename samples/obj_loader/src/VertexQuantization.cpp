@@ -0,0 +1,76 @@
+#include "VertexQuantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    inline float signNotZero(float value)
+    {
+        return value >= 0 ? 1.0f : -1.0f;
+    }
+
+}
+
+uint16_t quantizeUnorm16(float value, float min, float max)
+{
+    if (max <= min)
+    {
+        return 0;
+    }
+    auto normalized = std::min(std::max((value - min) / (max - min), 0.0f), 1.0f);
+    return (uint16_t)lrintf(normalized * 65535);
+}
+
+uint16_t quantizeHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    auto sign = (uint16_t)((bits >> 16) & 0x8000);
+    auto magnitude = bits & 0x7fffffff;
+
+    // nan
+    if (magnitude > 0x7f800000)
+    {
+        return sign | 0x7e00;
+    }
+    // 65520 and above round to infinity
+    if (magnitude >= 0x477ff000)
+    {
+        return sign | 0x7c00;
+    }
+    // under 2^-14 only denormals (multiples of 2^-24) are left
+    if (magnitude < 0x38800000)
+    {
+        float absolute;
+        memcpy(&absolute, &magnitude, sizeof(absolute));
+        return sign | (uint16_t)lrintf(absolute * 16777216.0f);
+    }
+
+    // rebias the exponent (127 -> 15) and round the mantissa to nearest even
+    magnitude -= (127 - 15) << 23;
+    magnitude += 0xfff + ((magnitude >> 13) & 1);
+    return sign | (uint16_t)(magnitude >> 13);
+}
+
+void encodeOctahedral(const float normal[3], int16_t encodedNormal[2])
+{
+    auto l1Norm = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    float x = 0, y = 0;
+    if (l1Norm > 0)
+    {
+        x = normal[0] / l1Norm;
+        y = normal[1] / l1Norm;
+        // the lower hemisphere is folded over the diagonals
+        if (normal[2] < 0)
+        {
+            auto foldedX = (1 - fabsf(y)) * signNotZero(x);
+            auto foldedY = (1 - fabsf(x)) * signNotZero(y);
+            x = foldedX;
+            y = foldedY;
+        }
+    }
+    encodedNormal[0] = (int16_t)lrintf(std::min(std::max(x, -1.0f), 1.0f) * 32767);
+    encodedNormal[1] = (int16_t)lrintf(std::min(std::max(y, -1.0f), 1.0f) * 32767);
+}
@@ -0,0 +1,13 @@
+#ifndef VERTEXQUANTIZATION_H
+#define VERTEXQUANTIZATION_H
+
+#include <cstdint>
+
+// value in [min, max] to the full [0, 65535] range (dequantized as min + unorm * (max - min))
+uint16_t quantizeUnorm16(float value, float min, float max);
+// rounds to nearest, overflows to infinity
+uint16_t quantizeHalf(float value);
+// unit vector to the octahedron unfolded onto [-1, 1]^2 (snorm16)
+void encodeOctahedral(const float normal[3], int16_t encodedNormal[2]);
+
+#endif
@@ -2,8 +2,14 @@
 
 int main(int argc, char **argv)
 {
+    vkfw::ApplicationSettings settings;
+    settings.name = "obj_loader";
+    // gpu culling needs multi-draw indirect, indirect draw counts spare it from issuing the culled (empty) draws
+    settings.optionalDeviceExtensions = {VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME};
+    settings.optionalDeviceFeatures.multiDrawIndirect = VK_TRUE;
+
     ObjLoaderApplication app;
-    app.initialize({"obj_loader"});
+    app.initialize(settings);
     app.run(argc, argv);
     return 0;
-}
\ No newline at end of file
+}
@@ -2,51 +2,14 @@
 
 #include <vkfw/vkfw.h>
 
+#if defined VKFW_EMBED_SPIRV
+#include <embedded_spirv.h>
+#endif
+
+#include <functional>
+
 namespace
 {
-    void createRenderPass(VkDevice device, const VkAllocationCallbacks *allocCb, VkFormat swapChainFormat, VkRenderPass &renderPass)
-    {
-        VkAttachmentDescription colorAttachmentDescription;
-        colorAttachmentDescription.flags = 0;
-        colorAttachmentDescription.format = swapChainFormat;
-        colorAttachmentDescription.samples = VK_SAMPLE_COUNT_1_BIT;
-        colorAttachmentDescription.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        colorAttachmentDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        colorAttachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        colorAttachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        colorAttachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        colorAttachmentDescription.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkAttachmentReference colorAttachmentReference;
-        colorAttachmentReference.attachment = 0;
-        colorAttachmentReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription subpassDescription;
-        subpassDescription.flags = 0;
-        subpassDescription.colorAttachmentCount = 1;
-        subpassDescription.pColorAttachments = &colorAttachmentReference;
-        subpassDescription.pDepthStencilAttachment = nullptr;
-        subpassDescription.inputAttachmentCount = 0;
-        subpassDescription.pInputAttachments = nullptr;
-        subpassDescription.preserveAttachmentCount = 0;
-        subpassDescription.pPreserveAttachments = nullptr;
-        subpassDescription.pResolveAttachments = nullptr;
-        subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-
-        VkRenderPassCreateInfo renderPassCreateInfo;
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.pNext = nullptr;
-        renderPassCreateInfo.flags = 0;
-        renderPassCreateInfo.attachmentCount = 1;
-        renderPassCreateInfo.pAttachments = &colorAttachmentDescription;
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpassDescription;
-        renderPassCreateInfo.dependencyCount = 0;
-        renderPassCreateInfo.pDependencies = nullptr;
-
-        vkfwCheckVkResult(vkCreateRenderPass(device, &renderPassCreateInfo, allocCb, &renderPass));
-    }
-
     void beginRenderPass(VkCommandBuffer commandBuffer, VkRenderPass renderPass, uint32_t width, uint32_t height, VkFramebuffer framebuffer)
     {
         VkRenderPassBeginInfo renderPassBeginInfo;
@@ -76,136 +39,6 @@ namespace
         vkfwCheckVkResult(vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, allocCb, &pipelineLayout));
     }
 
-    void initShaderStageCreateInfo(VkShaderModule module, VkShaderStageFlagBits stage, VkPipelineShaderStageCreateInfo &shaderStageCreateInfo)
-    {
-        shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        shaderStageCreateInfo.pNext = nullptr;
-        shaderStageCreateInfo.flags = 0;
-        shaderStageCreateInfo.module = module;
-        shaderStageCreateInfo.stage = stage;
-        shaderStageCreateInfo.pName = "main";
-        shaderStageCreateInfo.pSpecializationInfo = nullptr;
-    }
-
-    void createGraphicsPipeline(VkDevice device, const VkAllocationCallbacks *allocCb, VkShaderModule vertModule, VkShaderModule fragModule, VkPipelineLayout pipelineLayout, VkRenderPass renderPass, VkPipeline &pipeline)
-    {
-        VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo;
-        graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        graphicsPipelineCreateInfo.pNext = nullptr;
-        graphicsPipelineCreateInfo.flags = 0;
-
-        graphicsPipelineCreateInfo.layout = pipelineLayout;
-        graphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
-        graphicsPipelineCreateInfo.basePipelineIndex = 0;
-        graphicsPipelineCreateInfo.renderPass = renderPass;
-        graphicsPipelineCreateInfo.subpass = 0;
-
-        VkPipelineShaderStageCreateInfo shaderStageCreateInfos[2];
-        initShaderStageCreateInfo(vertModule, VK_SHADER_STAGE_VERTEX_BIT, shaderStageCreateInfos[0]);
-        initShaderStageCreateInfo(fragModule, VK_SHADER_STAGE_FRAGMENT_BIT, shaderStageCreateInfos[1]);
-        graphicsPipelineCreateInfo.stageCount = vkfwArraySize(shaderStageCreateInfos);
-        graphicsPipelineCreateInfo.pStages = shaderStageCreateInfos;
-
-        const VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-        VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo;
-        dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicStateCreateInfo.pNext = nullptr;
-        dynamicStateCreateInfo.flags = 0;
-        dynamicStateCreateInfo.dynamicStateCount = vkfwArraySize(dynamicStates);
-        dynamicStateCreateInfo.pDynamicStates = dynamicStates;
-        graphicsPipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
-
-        VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo;
-        vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInputStateCreateInfo.pNext = nullptr;
-        vertexInputStateCreateInfo.flags = 0;
-        vertexInputStateCreateInfo.vertexBindingDescriptionCount = 0;
-        vertexInputStateCreateInfo.pVertexBindingDescriptions = nullptr;
-        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = 0;
-        vertexInputStateCreateInfo.pVertexAttributeDescriptions = nullptr;
-        graphicsPipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
-
-        VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo;
-        inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssemblyStateCreateInfo.pNext = nullptr;
-        inputAssemblyStateCreateInfo.flags = 0;
-        inputAssemblyStateCreateInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
-        graphicsPipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
-
-        VkViewport viewport{};
-        VkRect2D scissorRect{};
-
-        VkPipelineViewportStateCreateInfo viewportStateCreateInfo;
-        viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportStateCreateInfo.pNext = nullptr;
-        viewportStateCreateInfo.flags = 0;
-        // even though we define viewport and scissor as dynamic states, we need to setup them
-        // cause spec states that if the multiple viewports feature is not enabled, viewportCount/scissorCount must be 1
-        // source: https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#VUID-VkPipelineViewportStateCreateInfo-viewportCount-01216
-        viewportStateCreateInfo.viewportCount = 1;
-        viewportStateCreateInfo.pViewports = &viewport;
-        viewportStateCreateInfo.scissorCount = 1;
-        viewportStateCreateInfo.pScissors = &scissorRect;
-        graphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-
-        VkPipelineRasterizationStateCreateInfo rasterizationStateCreateInfo;
-        rasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizationStateCreateInfo.pNext = nullptr;
-        rasterizationStateCreateInfo.flags = 0;
-        rasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
-        rasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
-        rasterizationStateCreateInfo.polygonMode = VK_POLYGON_MODE_FILL;
-        rasterizationStateCreateInfo.cullMode = VK_CULL_MODE_BACK_BIT;
-        rasterizationStateCreateInfo.frontFace = VK_FRONT_FACE_CLOCKWISE;
-        rasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
-        rasterizationStateCreateInfo.depthBiasConstantFactor = 0;
-        rasterizationStateCreateInfo.depthBiasClamp = 0;
-        rasterizationStateCreateInfo.depthBiasSlopeFactor = 0;
-        rasterizationStateCreateInfo.lineWidth = 1;
-        graphicsPipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
-
-        VkPipelineMultisampleStateCreateInfo multisampleStateCreateInfo;
-        multisampleStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampleStateCreateInfo.pNext = nullptr;
-        multisampleStateCreateInfo.flags = 0;
-        multisampleStateCreateInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        multisampleStateCreateInfo.sampleShadingEnable = VK_FALSE;
-        multisampleStateCreateInfo.minSampleShading = 0;
-        multisampleStateCreateInfo.pSampleMask = nullptr;
-        multisampleStateCreateInfo.alphaToCoverageEnable = VK_FALSE;
-        multisampleStateCreateInfo.alphaToOneEnable = VK_FALSE;
-        graphicsPipelineCreateInfo.pMultisampleState = &multisampleStateCreateInfo;
-
-        VkPipelineColorBlendAttachmentState colorBlendAttachmentState;
-        colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachmentState.blendEnable = VK_FALSE;
-        colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
-        colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-        colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
-
-        VkPipelineColorBlendStateCreateInfo colorBlendStateCreateInfo;
-        colorBlendStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlendStateCreateInfo.pNext = nullptr;
-        colorBlendStateCreateInfo.flags = 0;
-        colorBlendStateCreateInfo.logicOpEnable = VK_FALSE;
-        colorBlendStateCreateInfo.logicOp = VK_LOGIC_OP_CLEAR;
-        colorBlendStateCreateInfo.attachmentCount = 1;
-        colorBlendStateCreateInfo.pAttachments = &colorBlendAttachmentState;
-        colorBlendStateCreateInfo.blendConstants[0] = 0;
-        colorBlendStateCreateInfo.blendConstants[1] = 0;
-        colorBlendStateCreateInfo.blendConstants[2] = 0;
-        colorBlendStateCreateInfo.blendConstants[3] = 0;
-        graphicsPipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
-
-        graphicsPipelineCreateInfo.pDepthStencilState = nullptr;
-
-        vkfwCheckVkResult(vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &graphicsPipelineCreateInfo, allocCb, &pipeline));
-    }
-
     void createImageView(VkDevice device, const VkAllocationCallbacks *allocCb, VkFormat format, VkImage image, VkImageView &imageView)
     {
         VkImageViewCreateInfo imageViewCreateInfo;
@@ -225,30 +58,14 @@ namespace
         vkfwCheckVkResult(vkCreateImageView(device, &imageViewCreateInfo, allocCb, &imageView));
     }
 
-    void createFramebuffer(VkDevice device, const VkAllocationCallbacks *allocCb, VkRenderPass renderPass, VkImageView imageView, uint32_t width, uint32_t height, VkFramebuffer &framebuffer)
-    {
-        VkFramebufferCreateInfo framebufferCreateInfo;
-        framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferCreateInfo.pNext = nullptr;
-        framebufferCreateInfo.flags = 0;
-        framebufferCreateInfo.renderPass = renderPass;
-        framebufferCreateInfo.attachmentCount = 1;
-        framebufferCreateInfo.pAttachments = &imageView;
-        framebufferCreateInfo.width = width;
-        framebufferCreateInfo.height = height;
-        framebufferCreateInfo.layers = 1;
-
-        vkfwCheckVkResult(vkCreateFramebuffer(device, &framebufferCreateInfo, allocCb, &framebuffer));
-    }
-
-    VkShaderModule createShaderModule(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::FileData &code)
+    VkShaderModule createShaderModule(VkDevice device, const VkAllocationCallbacks *allocCb, const vkfw::ShaderCode &code)
     {
         VkShaderModuleCreateInfo shaderModuleCreateInfo;
         shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
         shaderModuleCreateInfo.pNext = nullptr;
         shaderModuleCreateInfo.flags = 0;
         shaderModuleCreateInfo.codeSize = code.size;
-        shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t *>(code.value.get());
+        shaderModuleCreateInfo.pCode = code.code;
         VkShaderModule shaderModule;
         vkfwCheckVkResult(vkCreateShaderModule(device, &shaderModuleCreateInfo, allocCb, &shaderModule));
         return shaderModule;
@@ -258,92 +75,124 @@ namespace
 
 void SampleApplication::postInitialize()
 {
-    createRenderPass(getDevice(), getAllocationCallbacks(), getSwapChainSurfaceFormat().format, m_renderPass);
+    vkfw::RenderPassDescription renderPassDescription;
+    auto &colorAttachment = renderPassDescription.colorAttachments[renderPassDescription.colorAttachmentCount++];
+    colorAttachment.format = getSwapChainSurfaceFormat().format;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    // layout transitions happen outside of the render pass, issued by the render graph
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    m_renderPass = getRenderPassCache().get(renderPassDescription);
 
     createPipelineLayout(getDevice(), getAllocationCallbacks(), m_pipelineLayout);
 
-    m_vertModule = createShaderModule(getDevice(), getAllocationCallbacks(), vkfw::readFile("spirv/triangle.vert.spv"));
-    m_fragModule = createShaderModule(getDevice(), getAllocationCallbacks(), vkfw::readFile("spirv/triangle.frag.spv"));
-    createGraphicsPipeline(getDevice(), getAllocationCallbacks(), m_vertModule, m_fragModule, m_pipelineLayout, m_renderPass, m_pipeline);
-
-    recreateSwapChainImageViewsAndFramebuffers();
+#if defined VKFW_EMBED_SPIRV
+    getShaderRegistry().add(gc_embeddedShaders, vkfwArraySize(gc_embeddedShaders));
+#endif
+    m_vertModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("triangle.vert"));
+    m_fragModule = createShaderModule(getDevice(), getAllocationCallbacks(), getShaderRegistry().get("triangle.frag"));
+    // compiled by a worker, the triangle is skipped until it's ready
+    m_pipeline = getPipelineCache().requestAsync(vkfw::GraphicsPipelineBuilder(m_pipelineLayout, m_renderPass)
+                                                     .setShaders(m_vertModule, m_fragModule)
+                                                     .setRasterization(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_CLOCKWISE)
+                                                     .addColorAttachment()
+                                                     .build());
+
+    recreateSwapChainImageViews();
+
+    m_renderGraph = std::make_unique<vkfw::RenderGraph>(getDevice(), getAllocationCallbacks(), std::bind(&SampleApplication::findMemoryType, this, std::placeholders::_1, std::placeholders::_2), getMaxSimultaneousFrames());
 }
 
 void SampleApplication::postRun()
 {
-    destroySwapChainImageViewsAndFramebuffers();
+    m_renderGraph = nullptr;
 
-    if (m_pipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(getDevice(), m_pipeline, getAllocationCallbacks());
-        m_pipeline = VK_NULL_HANDLE;
-    }
+    destroySwapChainImageViews();
+
+    // pipelines are owned by the pipeline cache
+    m_pipeline = {};
     if (m_fragModule != VK_NULL_HANDLE)
     {
+        getPipelineCache().evictShaderModule(m_fragModule);
         vkDestroyShaderModule(getDevice(), m_fragModule, getAllocationCallbacks());
         m_fragModule = VK_NULL_HANDLE;
     }
     if (m_vertModule != VK_NULL_HANDLE)
     {
+        getPipelineCache().evictShaderModule(m_vertModule);
         vkDestroyShaderModule(getDevice(), m_vertModule, getAllocationCallbacks());
         m_vertModule = VK_NULL_HANDLE;
     }
     if (m_pipelineLayout != VK_NULL_HANDLE)
     {
+        getPipelineCache().evictPipelineLayout(m_pipelineLayout);
         vkDestroyPipelineLayout(getDevice(), m_pipelineLayout, getAllocationCallbacks());
         m_pipelineLayout = VK_NULL_HANDLE;
     }
-    if (m_renderPass != VK_NULL_HANDLE)
-    {
-        vkDestroyRenderPass(getDevice(), m_renderPass, getAllocationCallbacks());
-        m_renderPass = VK_NULL_HANDLE;
-    }
+    m_renderPass = VK_NULL_HANDLE;
 }
 
 void SampleApplication::postResize(uint32_t width, uint32_t height)
 {
-    recreateSwapChainImageViewsAndFramebuffers();
+    recreateSwapChainImageViews();
 }
 
 void SampleApplication::record(VkCommandBuffer commandBuffer)
 {
-    beginRenderPass(commandBuffer, m_renderPass, getWidth(), getHeight(), m_framebuffers[getSwapChainIndex()]);
+    m_renderGraph->reset();
+
+    m_renderGraph->importImage("swapChain", getSwapChainImage(getSwapChainIndex()), m_swapChainImageViews[getSwapChainIndex()], VK_IMAGE_ASPECT_COLOR_BIT, vkfw::ResourceUsage::SwapChainAcquire, vkfw::ResourceUsage::Present);
 
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    m_renderGraph->addPass("triangle", [this](VkCommandBuffer commandBuffer, const vkfw::RenderGraph &renderGraph)
+                           {
+                               vkfw::FramebufferDescription framebufferDescription;
+                               framebufferDescription.renderPass = m_renderPass;
+                               framebufferDescription.attachments[framebufferDescription.attachmentCount++] = renderGraph.getImageView("swapChain");
+                               framebufferDescription.width = getWidth();
+                               framebufferDescription.height = getHeight();
 
-    VkViewport viewport{0, 0, (float)getWidth(), (float)getHeight(), 0, 1};
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+                               beginRenderPass(commandBuffer, m_renderPass, getWidth(), getHeight(), getFramebufferCache().get(framebufferDescription));
 
-    VkRect2D scissorRect{0, 0, getWidth(), getHeight()};
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+                               auto pipeline = m_pipeline.get();
+                               if (pipeline != VK_NULL_HANDLE)
+                               {
+                                   vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+                                   VkViewport viewport{0, 0, (float)getWidth(), (float)getHeight(), 0, 1};
+                                   vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    vkCmdEndRenderPass(commandBuffer);
+                                   VkRect2D scissorRect{0, 0, getWidth(), getHeight()};
+                                   vkCmdSetScissor(commandBuffer, 0, 1, &scissorRect);
+
+                                   vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+                               }
+
+                               vkCmdEndRenderPass(commandBuffer);
+                           })
+        .write("swapChain", vkfw::ResourceUsage::ColorAttachment);
+
+    m_renderGraph->compile();
+    m_renderGraph->execute(commandBuffer, getCurrentFrame());
 }
 
-void SampleApplication::recreateSwapChainImageViewsAndFramebuffers()
+void SampleApplication::recreateSwapChainImageViews()
 {
-    destroySwapChainImageViewsAndFramebuffers();
+    destroySwapChainImageViews();
 
     m_swapChainImageViews.resize(getSwapChainCount());
-    m_framebuffers.resize(getSwapChainCount());
     for (uint32_t i = 0; i < getSwapChainCount(); ++i)
     {
         createImageView(getDevice(), getAllocationCallbacks(), getSwapChainSurfaceFormat().format, getSwapChainImage(i), m_swapChainImageViews[i]);
-        createFramebuffer(getDevice(), getAllocationCallbacks(), m_renderPass, m_swapChainImageViews[i], getWidth(), getHeight(), m_framebuffers[i]);
     }
 }
 
-void SampleApplication::destroySwapChainImageViewsAndFramebuffers()
+void SampleApplication::destroySwapChainImageViews()
 {
-    for (auto &framebuffer : m_framebuffers)
-    {
-        vkDestroyFramebuffer(getDevice(), framebuffer, getAllocationCallbacks());
-    }
-
     for (auto &swapChainImageView : m_swapChainImageViews)
     {
+        getFramebufferCache().evictImageView(swapChainImageView);
         vkDestroyImageView(getDevice(), swapChainImageView, getAllocationCallbacks());
     }
+    m_swapChainImageViews.clear();
 }
\ No newline at end of file
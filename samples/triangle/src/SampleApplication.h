@@ -1,5 +1,7 @@
 #include <vkfw/Application.h>
+#include <vkfw/RenderGraph.h>
 
+#include <memory>
 #include <vector>
 
 class SampleApplication : public vkfw::Application
@@ -14,14 +16,14 @@ protected:
     void postResize(uint32_t width, uint32_t height) override;
 
 private:
-    void recreateSwapChainImageViewsAndFramebuffers();
-    void destroySwapChainImageViewsAndFramebuffers();
+    void recreateSwapChainImageViews();
+    void destroySwapChainImageViews();
 
     VkShaderModule m_vertModule{VK_NULL_HANDLE};
     VkShaderModule m_fragModule{VK_NULL_HANDLE};
     VkRenderPass m_renderPass{VK_NULL_HANDLE};
     VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
-    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    vkfw::PipelineHandle m_pipeline;
     std::vector<VkImageView> m_swapChainImageViews;
-    std::vector<VkFramebuffer> m_framebuffers;
+    std::unique_ptr<vkfw::RenderGraph> m_renderGraph;
 };
\ No newline at end of file
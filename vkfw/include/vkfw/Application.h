@@ -1,6 +1,12 @@
 #ifndef VKFW_APPLICATION_H
 #define VKFW_APPLICATION_H
 
+#include <vkfw/AsyncFileReader.h>
+#include <vkfw/FramebufferCache.h>
+#include <vkfw/PipelineCache.h>
+#include <vkfw/RenderPassCache.h>
+#include <vkfw/ShaderRegistry.h>
+#include <vkfw/ThreadPool.h>
 #include <vkfw/vkfw.h>
 
 #include <cstdint>
@@ -19,6 +25,12 @@ namespace vkfw
 		uint32_t majorVersion{1};
 		uint32_t minorVersion{0};
 		uint32_t patchVersion{0};
+		// 0 means one less than the number of hardware threads (the main thread keeps one)
+		uint32_t workerThreadCount{0};
+		uint32_t ioThreadCount{2};
+		// only enabled if the physical device supports them (see isDeviceExtensionEnabled and getEnabledDeviceFeatures)
+		std::vector<std::string> optionalDeviceExtensions;
+		VkPhysicalDeviceFeatures optionalDeviceFeatures{};
 	};
 
 	constexpr uint32_t gc_invalidQueueIndex = ~0;
@@ -101,8 +113,50 @@ namespace vkfw
 			return m_allocationCallbacks.get();
 		}
 
+		inline const VkPhysicalDeviceLimits &getPhysicalDeviceLimits() const
+		{
+			return m_physicalDeviceProperties.limits;
+		}
+
 		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 
+		bool isDeviceExtensionEnabled(const char *name) const;
+
+		inline const VkPhysicalDeviceFeatures &getEnabledDeviceFeatures() const
+		{
+			return m_enabledDeviceFeatures;
+		}
+
+		inline ShaderRegistry &getShaderRegistry()
+		{
+			return m_shaderRegistry;
+		}
+
+		inline ThreadPool &getThreadPool()
+		{
+			return *m_threadPool;
+		}
+
+		inline AsyncFileReader &getFileReader()
+		{
+			return *m_fileReader;
+		}
+
+		inline RenderPassCache &getRenderPassCache()
+		{
+			return *m_renderPassCache;
+		}
+
+		inline FramebufferCache &getFramebufferCache()
+		{
+			return *m_framebufferCache;
+		}
+
+		inline PipelineCache &getPipelineCache()
+		{
+			return *m_pipelineCache;
+		}
+
 		inline uint32_t getGraphicsQueueFamilyIndex() const
 		{
 			return m_graphicsAndPresentQueueFamilyIndex;
@@ -121,7 +175,7 @@ namespace vkfw
 		void createSurface();
 		void destroySurface();
 		void selectPhysicalDevice();
-		void getPhysicalDeviceMemoryProperties();
+		void getPhysicalDevicePropertiesAndMemoryProperties();
 		void createDeviceAndGetQueues();
 		void destroyDeviceAndClearQueues();
 		void createSwapChainAndGetImages();
@@ -131,6 +185,8 @@ namespace vkfw
 		void destroySynchronizationObjects();
 		void createCommandPoolAndCommandBuffers();
 		void destroyCommandPoolAndCommandBuffers();
+		void createCaches();
+		void destroyCaches();
 		void runOneFrame();
 		void finalize();
 		void render();
@@ -158,9 +214,12 @@ namespace vkfw
 		VkInstance m_instance{VK_NULL_HANDLE};
 		VkSurfaceKHR m_surface{VK_NULL_HANDLE};
 		VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
+		VkPhysicalDeviceProperties m_physicalDeviceProperties;
 		VkPhysicalDeviceMemoryProperties m_physicalDeviceMemoryProperties;
 		std::unique_ptr<VkAllocationCallbacks> m_allocationCallbacks{nullptr};
 		VkDevice m_device{VK_NULL_HANDLE};
+		std::vector<std::string> m_enabledDeviceExtensions;
+		VkPhysicalDeviceFeatures m_enabledDeviceFeatures{};
 		uint32_t m_graphicsAndPresentQueueFamilyIndex{gc_invalidQueueIndex};
 		VkQueue m_graphicsAndPresentQueue{VK_NULL_HANDLE};
 		VkSurfaceTransformFlagBitsKHR m_preTransform;
@@ -175,6 +234,12 @@ namespace vkfw
 		std::vector<VkFence> m_frameFences;
 		VkCommandPool m_commandPool{VK_NULL_HANDLE};
 		std::vector<VkCommandBuffer> m_commandBuffers;
+		ShaderRegistry m_shaderRegistry;
+		std::unique_ptr<AsyncFileReader> m_fileReader;
+		std::unique_ptr<ThreadPool> m_threadPool;
+		std::unique_ptr<RenderPassCache> m_renderPassCache;
+		std::unique_ptr<FramebufferCache> m_framebufferCache;
+		std::unique_ptr<PipelineCache> m_pipelineCache;
 	};
 
 }
@@ -0,0 +1,36 @@
+#ifndef VKFW_ASYNCFILEREADER_H
+#define VKFW_ASYNCFILEREADER_H
+
+#include <vkfw/MappedFile.h>
+#include <vkfw/ThreadPool.h>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace vkfw
+{
+	// reads files on dedicated I/O threads, so that neither the main thread nor the CPU workers block on disk.
+	// a read completes only once every page of the file is resident, so consumers never fault on disk afterwards.
+	// use TaskPriority::Low for streaming requests, so that they're overtaken by anything more urgent
+	class AsyncFileReader
+	{
+	public:
+		using CompletionCb = std::function<void(MappedFile)>;
+
+		explicit AsyncFileReader(uint32_t threadCount);
+
+		std::future<MappedFile> read(const std::string &filename, TaskPriority priority = TaskPriority::Normal, FileAccessPattern accessPattern = FileAccessPattern::Sequential);
+		std::vector<std::future<MappedFile>> read(const std::vector<std::string> &filenames, TaskPriority priority = TaskPriority::Normal, FileAccessPattern accessPattern = FileAccessPattern::Sequential);
+		// the callback is invoked on an I/O thread
+		void read(const std::string &filename, CompletionCb callback, TaskPriority priority = TaskPriority::Normal, FileAccessPattern accessPattern = FileAccessPattern::Sequential);
+
+	private:
+		ThreadPool m_threadPool;
+	};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef VKFW_FRAMEBUFFERCACHE_H
+#define VKFW_FRAMEBUFFERCACHE_H
+
+#include <vkfw/RenderPassCache.h>
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace vkfw
+{
+	constexpr uint32_t gc_maxFramebufferAttachments = gc_maxColorAttachments + 1;
+
+	struct FramebufferDescription
+	{
+		VkRenderPass renderPass{VK_NULL_HANDLE};
+		VkImageView attachments[gc_maxFramebufferAttachments]{};
+		uint32_t attachmentCount{0};
+		uint32_t width{0};
+		uint32_t height{0};
+		uint32_t layers{1};
+
+		bool operator==(const FramebufferDescription &other) const;
+		size_t getHash() const;
+	};
+
+	// framebuffers are keyed by handles, and handles may be recycled by the driver once destroyed,
+	// so image views (and render passes) must be evicted before they're destroyed
+	class FramebufferCache
+	{
+	public:
+		FramebufferCache(VkDevice device, const VkAllocationCallbacks *allocCb);
+		~FramebufferCache();
+
+		FramebufferCache(const FramebufferCache &) = delete;
+		FramebufferCache &operator=(const FramebufferCache &) = delete;
+
+		VkFramebuffer get(const FramebufferDescription &description);
+		void evictImageView(VkImageView imageView);
+		void evictRenderPass(VkRenderPass renderPass);
+		void clear();
+
+		inline size_t getSize() const
+		{
+			return m_framebuffers.size();
+		}
+
+	private:
+		struct DescriptionHash
+		{
+			size_t operator()(const FramebufferDescription &description) const
+			{
+				return description.getHash();
+			}
+		};
+
+		template <typename PredicateType>
+		void evictIf(PredicateType predicate);
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		std::unordered_map<FramebufferDescription, VkFramebuffer, DescriptionHash> m_framebuffers;
+	};
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef VKFW_FRUSTUMCULLING_H
+#define VKFW_FRUSTUMCULLING_H
+
+#include <vkfw/ThreadPool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkfw
+{
+	// xyz: normal (normalized, pointing inside), w: distance
+	struct Frustum
+	{
+		float planes[6][4];
+	};
+
+	// the planes bounding clip space (0 <= z <= w), in the space clip (column major, ie.: projection * view * model) transforms from
+	Frustum extractFrustum(const float clip[16]);
+
+	// axis aligned boxes and bounding spheres around the same centers, stored as a structure of arrays
+	// (padded to the SIMD width) so that batches of them can be tested at once
+	class BoundingVolumes
+	{
+	public:
+		// returns the index of the bounds, radius can be tighter than the box's half diagonal
+		size_t add(const float boundsMin[3], const float boundsMax[3], float radius);
+		void clear();
+
+		// sets visibility[i] to 1 if both the box and the sphere of bounds i intersect the frustum, to 0 otherwise.
+		// spread over the thread pool (if there's one) in batches, once there are enough bounds to make it worth it
+		void cull(const Frustum &frustum, uint8_t *visibility, ThreadPool *threadPool = nullptr) const;
+
+		inline size_t getCount() const
+		{
+			return m_count;
+		}
+
+	private:
+		enum Stream
+		{
+			CenterX,
+			CenterY,
+			CenterZ,
+			ExtentX,
+			ExtentY,
+			ExtentZ,
+			Radius,
+			StreamCount
+		};
+
+		void cullRange(const Frustum &frustum, size_t first, size_t last, uint8_t *visibility) const;
+
+		std::vector<float> m_streams[StreamCount];
+		size_t m_count{0};
+	};
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef VKFW_GEOMETRYARENA_H
+#define VKFW_GEOMETRYARENA_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vkfw
+{
+	// in elements, ready to be used as vkCmdDrawIndexed's vertexOffset and firstIndex
+	struct GeometryAllocation
+	{
+		uint32_t block;
+		uint32_t vertexOffset;
+		uint32_t firstIndex;
+		// in bytes, for copying the data in
+		VkDeviceSize vertexBufferOffset;
+		VkDeviceSize indexBufferOffset;
+	};
+
+	// packs the vertices and indices of many meshes into a few shared device local buffers (blocks), so that they can be drawn
+	// with a single vertex/index buffer bind per block. allocations are linear and only freed all at once.
+	// a new block is created whenever an allocation doesn't fit in the last one (sized to fit it, if it's bigger than a block)
+	class GeometryArena
+	{
+	public:
+		GeometryArena(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, VkDeviceSize vertexBlockSize, VkDeviceSize indexBlockSize);
+		~GeometryArena();
+
+		GeometryArena(const GeometryArena &) = delete;
+		GeometryArena &operator=(const GeometryArena &) = delete;
+
+		// vertices are aligned to vertexStride and indices to 4 bytes, so both index types can address them
+		GeometryAllocation allocate(VkDeviceSize vertexCount, VkDeviceSize vertexStride, VkDeviceSize indexCount, VkDeviceSize indexSize);
+		void clear();
+
+		inline uint32_t getBlockCount() const
+		{
+			return (uint32_t)m_blocks.size();
+		}
+
+		inline VkBuffer getVertexBuffer(uint32_t block) const
+		{
+			return m_blocks[block].vertexBuffer;
+		}
+
+		inline VkBuffer getIndexBuffer(uint32_t block) const
+		{
+			return m_blocks[block].indexBuffer;
+		}
+
+	private:
+		struct Block
+		{
+			VkBuffer vertexBuffer{VK_NULL_HANDLE};
+			VkDeviceMemory vertexMemory{VK_NULL_HANDLE};
+			VkBuffer indexBuffer{VK_NULL_HANDLE};
+			VkDeviceMemory indexMemory{VK_NULL_HANDLE};
+			VkDeviceSize vertexBufferSize{0};
+			VkDeviceSize indexBufferSize{0};
+			VkDeviceSize usedVertexBufferSize{0};
+			VkDeviceSize usedIndexBufferSize{0};
+		};
+
+		void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer &buffer, VkDeviceMemory &memory);
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		FindMemoryTypeCb m_findMemoryTypeCb;
+		VkDeviceSize m_vertexBlockSize;
+		VkDeviceSize m_indexBlockSize;
+		std::vector<Block> m_blocks;
+	};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef VKFW_GRAPHICSPIPELINEDESCRIPTION_H
+#define VKFW_GRAPHICSPIPELINEDESCRIPTION_H
+
+#include <vkfw/RenderPassCache.h>
+#include <vkfw/vkfw.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+// map entry for a member of a specialization constants struct
+#define vkfwSpecializationMapEntry(constantID, SpecializationType, member) \
+	VkSpecializationMapEntry { (uint32_t)(constantID), (uint32_t)offsetof(SpecializationType, member), sizeof(SpecializationType::member) }
+
+namespace vkfw
+{
+	constexpr uint32_t gc_maxVertexBindings = 8;
+	constexpr uint32_t gc_maxVertexAttributes = 16;
+	constexpr uint32_t gc_maxSpecializationMapEntries = 16;
+	constexpr uint32_t gc_maxSpecializationDataSize = 64;
+
+	// specialization constants of a single shader stage, stored by value.
+	// only the mapped bytes are ever written to data, so padding in the source struct doesn't leak into the hash
+	struct SpecializationConstants
+	{
+		VkSpecializationMapEntry mapEntries[gc_maxSpecializationMapEntries]{};
+		uint32_t mapEntryCount{0};
+		uint8_t data[gc_maxSpecializationDataSize]{};
+		uint32_t dataSize{0};
+
+		bool operator==(const SpecializationConstants &other) const;
+		void hash(size_t &hash) const;
+	};
+
+	// all the state that goes into a graphics pipeline, stored by value (no pointers other than vulkan handles)
+	// so that it can be compared and hashed. viewport and scissor are always dynamic
+	struct GraphicsPipelineDescription
+	{
+		VkPipelineLayout layout{VK_NULL_HANDLE};
+		VkRenderPass renderPass{VK_NULL_HANDLE};
+		uint32_t subpass{0};
+		VkShaderModule vertexShader{VK_NULL_HANDLE};
+		VkShaderModule fragmentShader{VK_NULL_HANDLE};
+		SpecializationConstants vertexSpecialization;
+		SpecializationConstants fragmentSpecialization;
+		VkVertexInputBindingDescription vertexBindings[gc_maxVertexBindings]{};
+		uint32_t vertexBindingCount{0};
+		VkVertexInputAttributeDescription vertexAttributes[gc_maxVertexAttributes]{};
+		uint32_t vertexAttributeCount{0};
+		VkPrimitiveTopology topology{VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+		VkPolygonMode polygonMode{VK_POLYGON_MODE_FILL};
+		VkCullModeFlags cullMode{VK_CULL_MODE_NONE};
+		VkFrontFace frontFace{VK_FRONT_FACE_COUNTER_CLOCKWISE};
+		VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+		bool depthTestEnable{false};
+		bool depthWriteEnable{false};
+		VkCompareOp depthCompareOp{VK_COMPARE_OP_LESS};
+		VkPipelineColorBlendAttachmentState colorBlendAttachments[gc_maxColorAttachments]{};
+		uint32_t colorBlendAttachmentCount{0};
+
+		bool operator==(const GraphicsPipelineDescription &other) const;
+		size_t getHash() const;
+	};
+
+	class GraphicsPipelineBuilder
+	{
+	public:
+		GraphicsPipelineBuilder(VkPipelineLayout layout, VkRenderPass renderPass, uint32_t subpass = 0);
+
+		GraphicsPipelineBuilder &setShaders(VkShaderModule vertexShader, VkShaderModule fragmentShader);
+
+		// ie.: setSpecialization(VK_SHADER_STAGE_FRAGMENT_BIT, constants, {vkfwSpecializationMapEntry(0, Constants, member)})
+		template <typename SpecializationType>
+		GraphicsPipelineBuilder &setSpecialization(VkShaderStageFlagBits stage, const SpecializationType &specialization, std::initializer_list<VkSpecializationMapEntry> mapEntries)
+		{
+			static_assert(std::is_trivially_copyable<SpecializationType>::value, "specialization constants must be trivially copyable");
+			static_assert(sizeof(SpecializationType) <= gc_maxSpecializationDataSize, "specialization constants are too big");
+			return setSpecialization(stage, &specialization, (uint32_t)sizeof(SpecializationType), mapEntries.begin(), (uint32_t)mapEntries.size());
+		}
+
+		GraphicsPipelineBuilder &setSpecialization(VkShaderStageFlagBits stage, const void *data, uint32_t dataSize, const VkSpecializationMapEntry *mapEntries, uint32_t mapEntryCount);
+		GraphicsPipelineBuilder &addVertexBinding(uint32_t binding, uint32_t stride, VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX);
+		GraphicsPipelineBuilder &addVertexAttribute(uint32_t location, uint32_t binding, VkFormat format, uint32_t offset);
+		GraphicsPipelineBuilder &setTopology(VkPrimitiveTopology topology);
+		GraphicsPipelineBuilder &setRasterization(VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace);
+		GraphicsPipelineBuilder &setSamples(VkSampleCountFlagBits samples);
+		GraphicsPipelineBuilder &setDepthTest(bool depthWriteEnable, VkCompareOp depthCompareOp);
+		// opaque (blending disabled, all components written)
+		GraphicsPipelineBuilder &addColorAttachment();
+		GraphicsPipelineBuilder &addColorAttachment(const VkPipelineColorBlendAttachmentState &colorBlendAttachmentState);
+
+		inline const GraphicsPipelineDescription &build() const
+		{
+			return m_description;
+		}
+
+	private:
+		GraphicsPipelineDescription m_description;
+	};
+
+}
+
+#endif
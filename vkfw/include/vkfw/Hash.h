@@ -0,0 +1,24 @@
+#ifndef VKFW_HASH_H
+#define VKFW_HASH_H
+
+#include <cstddef>
+#include <functional>
+
+namespace vkfw
+{
+	template <typename ValueType>
+	inline void hashCombine(size_t &seed, const ValueType &value)
+	{
+		seed ^= std::hash<ValueType>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	template <typename FirstType, typename... OtherTypes>
+	inline void hashCombine(size_t &seed, const FirstType &first, const OtherTypes &...others)
+	{
+		hashCombine(seed, first);
+		hashCombine(seed, others...);
+	}
+
+}
+
+#endif
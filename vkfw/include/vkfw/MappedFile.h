@@ -0,0 +1,57 @@
+#ifndef VKFW_MAPPEDFILE_H
+#define VKFW_MAPPEDFILE_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstddef>
+#include <string>
+
+namespace vkfw
+{
+	enum class FileAccessPattern
+	{
+		Sequential,
+		Random
+	};
+
+	// read-only view of a whole file mapped into memory (zero-copy alternative to readFile).
+	// the data is valid for as long as the MappedFile lives
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string &filename, FileAccessPattern accessPattern = FileAccessPattern::Sequential);
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+		MappedFile(MappedFile &&other) noexcept;
+		MappedFile &operator=(MappedFile &&other) noexcept;
+
+		// empty files are open, but have no data
+		inline bool isOpen() const
+		{
+			return m_open;
+		}
+
+		inline const char *getData() const
+		{
+			return m_data;
+		}
+
+		inline size_t getSize() const
+		{
+			return m_size;
+		}
+
+	private:
+		void unmap();
+
+		const char *m_data{nullptr};
+		size_t m_size{0};
+		bool m_open{false};
+	};
+
+}
+
+#endif
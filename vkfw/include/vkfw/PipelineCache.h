@@ -0,0 +1,107 @@
+#ifndef VKFW_PIPELINECACHE_H
+#define VKFW_PIPELINECACHE_H
+
+#include <vkfw/GraphicsPipelineDescription.h>
+#include <vkfw/ThreadPool.h>
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace vkfw
+{
+	struct CompiledPipeline
+	{
+		VkPipeline pipeline{VK_NULL_HANDLE};
+		double creationTime{0};
+	};
+
+	// non-blocking view over a pipeline that may still be compiling
+	class PipelineHandle
+	{
+	public:
+		PipelineHandle() = default;
+
+		bool isReady() const;
+		// the pipeline if it's ready, the fallback otherwise (VK_NULL_HANDLE meaning whatever uses it should be skipped)
+		VkPipeline get() const;
+		VkPipeline wait() const;
+
+	private:
+		friend class PipelineCache;
+
+		PipelineHandle(std::shared_future<CompiledPipeline> compiledPipeline, VkPipeline fallback) : m_compiledPipeline(std::move(compiledPipeline)), m_fallback(fallback) {}
+
+		std::shared_future<CompiledPipeline> m_compiledPipeline;
+		VkPipeline m_fallback{VK_NULL_HANDLE};
+		mutable VkPipeline m_pipeline{VK_NULL_HANDLE};
+	};
+
+	// deduplicates graphics pipelines by description and batches their creation:
+	// request() only queues a description, flush() creates every queued one with a single vkCreateGraphicsPipelines call.
+	// get() flushes whatever is pending if the requested pipeline doesn't exist yet.
+	// requestAsync() compiles on the thread pool instead, so that pipelines created after startup don't stall the frame loop.
+	// every compilation goes through the same VkPipelineCache (which is internally synchronized), so drivers can share results
+	class PipelineCache
+	{
+	public:
+		PipelineCache(VkDevice device, const VkAllocationCallbacks *allocCb, ThreadPool &threadPool);
+		~PipelineCache();
+
+		PipelineCache(const PipelineCache &) = delete;
+		PipelineCache &operator=(const PipelineCache &) = delete;
+
+		void request(const GraphicsPipelineDescription &description);
+		void flush();
+		VkPipeline get(const GraphicsPipelineDescription &description);
+		PipelineHandle requestAsync(const GraphicsPipelineDescription &description, VkPipeline fallback = VK_NULL_HANDLE);
+		// in milliseconds. pipelines created in the same batch share the batch cost evenly
+		double getCreationTime(const GraphicsPipelineDescription &description) const;
+		void evictShaderModule(VkShaderModule shaderModule);
+		void evictPipelineLayout(VkPipelineLayout pipelineLayout);
+		void clear();
+
+		inline VkPipelineCache getHandle() const
+		{
+			return m_handle;
+		}
+
+		inline size_t getSize() const
+		{
+			return m_pipelines.size();
+		}
+
+		double getTotalCreationTime() const;
+
+	private:
+		struct DescriptionHash
+		{
+			size_t operator()(const GraphicsPipelineDescription &description) const
+			{
+				return description.getHash();
+			}
+		};
+
+		struct PendingPipeline
+		{
+			GraphicsPipelineDescription description;
+			std::shared_ptr<std::promise<CompiledPipeline>> promise;
+		};
+
+		template <typename PredicateType>
+		void evictIf(PredicateType predicate);
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		ThreadPool &m_threadPool;
+		VkPipelineCache m_handle{VK_NULL_HANDLE};
+		std::unordered_map<GraphicsPipelineDescription, std::shared_future<CompiledPipeline>, DescriptionHash> m_pipelines;
+		std::vector<PendingPipeline> m_pendingPipelines;
+	};
+
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef VKFW_PUSHCONSTANTS_H
+#define VKFW_PUSHCONSTANTS_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace vkfw
+{
+	// typed view over a push constant block, so that the range declared in the pipeline layout
+	// and the data pushed while recording always agree on size and offset
+	template <typename PushConstantsType>
+	struct PushConstants
+	{
+		static_assert(sizeof(PushConstantsType) % 4 == 0, "push constants size must be a multiple of 4");
+		static_assert(std::is_trivially_copyable<PushConstantsType>::value, "push constants must be trivially copyable");
+
+		static constexpr uint32_t size = (uint32_t)sizeof(PushConstantsType);
+
+		static VkPushConstantRange getRange(VkShaderStageFlags stageFlags, uint32_t offset = 0)
+		{
+			return VkPushConstantRange{stageFlags, offset, size};
+		}
+
+		static void push(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, VkShaderStageFlags stageFlags, const PushConstantsType &pushConstants, uint32_t offset = 0)
+		{
+			vkCmdPushConstants(commandBuffer, pipelineLayout, stageFlags, offset, size, &pushConstants);
+		}
+	};
+
+	Result validatePushConstantRanges(const VkPhysicalDeviceLimits &limits, const VkPushConstantRange *pushConstantRanges, uint32_t pushConstantRangeCount);
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef VKFW_RENDERGRAPH_H
+#define VKFW_RENDERGRAPH_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkfw
+{
+	enum class ResourceUsage
+	{
+		Undefined,
+		SwapChainAcquire,
+		ColorAttachment,
+		DepthStencilAttachment,
+		DepthStencilReadOnly,
+		SampledByFragmentShader,
+		SampledByComputeShader,
+		StorageByVertexShader,
+		StorageByComputeShader,
+		UniformBuffer,
+		VertexBuffer,
+		IndexBuffer,
+		IndirectBuffer,
+		TransferSource,
+		TransferDestination,
+		Present
+	};
+
+	struct RenderGraphImageDescription
+	{
+		VkFormat format{VK_FORMAT_UNDEFINED};
+		uint32_t width{0};
+		uint32_t height{0};
+		VkImageAspectFlags aspectMask{VK_IMAGE_ASPECT_COLOR_BIT};
+		VkImageUsageFlags usage{0};
+	};
+
+	struct RenderGraphBufferDescription
+	{
+		VkDeviceSize size{0};
+		VkBufferUsageFlags usage{0};
+	};
+
+	// passes declare which named images/buffers they read and write, and the graph derives:
+	// - which passes can be culled (nothing live consumes what they write),
+	// - the minimal set of barriers/layout transitions between live passes, batched into one vkCmdPipelineBarrier per pass,
+	// - which transient resources can share memory (their lifetimes don't overlap).
+	//
+	// the graph is meant to be rebuilt every frame (reset/declare/compile/execute);
+	// transient resources are allocated once per frame in flight and only recreated when their declarations change.
+	//
+	// a write that isn't accompanied by a read of the same resource discards its previous contents.
+	class RenderGraph
+	{
+	public:
+		using RecordCallback = std::function<void(VkCommandBuffer, const RenderGraph &)>;
+
+		class PassBuilder
+		{
+		public:
+			PassBuilder &read(const std::string &name, ResourceUsage usage);
+			PassBuilder &write(const std::string &name, ResourceUsage usage);
+			PassBuilder &setSideEffects();
+
+		private:
+			friend class RenderGraph;
+
+			PassBuilder(RenderGraph &renderGraph, uint32_t passIndex) : m_renderGraph(renderGraph), m_passIndex(passIndex) {}
+
+			RenderGraph &m_renderGraph;
+			uint32_t m_passIndex;
+		};
+
+		RenderGraph(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, uint32_t frameCount);
+		~RenderGraph();
+
+		RenderGraph(const RenderGraph &) = delete;
+		RenderGraph &operator=(const RenderGraph &) = delete;
+
+		void reset();
+		void importImage(const std::string &name, VkImage image, VkImageView imageView, VkImageAspectFlags aspectMask, ResourceUsage initialUsage, ResourceUsage finalUsage);
+		void importBuffer(const std::string &name, VkBuffer buffer, ResourceUsage initialUsage, ResourceUsage finalUsage);
+		void createImage(const std::string &name, const RenderGraphImageDescription &description);
+		void createBuffer(const std::string &name, const RenderGraphBufferDescription &description);
+		PassBuilder addPass(const std::string &name, RecordCallback recordCallback);
+		void compile();
+		void execute(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		VkImage getImage(const std::string &name) const;
+		VkImageView getImageView(const std::string &name) const;
+		VkBuffer getBuffer(const std::string &name) const;
+
+		inline uint32_t getCulledPassCount() const
+		{
+			return m_culledPassCount;
+		}
+
+		inline uint32_t getBarrierCount() const
+		{
+			return m_barrierCount;
+		}
+
+	private:
+		static constexpr uint32_t sc_noAliasSlot = ~0u;
+
+		struct Access
+		{
+			uint32_t resourceIndex;
+			VkPipelineStageFlags stageMask;
+			VkAccessFlags accessMask;
+			VkImageLayout layout;
+			bool read;
+			bool write;
+		};
+
+		struct ImageBarrier
+		{
+			uint32_t resourceIndex;
+			VkAccessFlags srcAccessMask;
+			VkAccessFlags dstAccessMask;
+			VkImageLayout oldLayout;
+			VkImageLayout newLayout;
+		};
+
+		struct Barrier
+		{
+			VkPipelineStageFlags srcStageMask{0};
+			VkPipelineStageFlags dstStageMask{0};
+			VkAccessFlags srcBufferAccessMask{0};
+			VkAccessFlags dstBufferAccessMask{0};
+			bool hasBufferBarrier{false};
+			std::vector<ImageBarrier> imageBarriers;
+		};
+
+		struct Pass
+		{
+			std::string name;
+			RecordCallback recordCallback;
+			std::vector<Access> accesses;
+			bool sideEffects{false};
+			bool culled{false};
+			Barrier barrier;
+		};
+
+		struct Resource
+		{
+			std::string name;
+			bool image{false};
+			bool imported{false};
+			RenderGraphImageDescription imageDescription;
+			RenderGraphBufferDescription bufferDescription;
+			VkImage importedImage{VK_NULL_HANDLE};
+			VkImageView importedImageView{VK_NULL_HANDLE};
+			VkBuffer importedBuffer{VK_NULL_HANDLE};
+			VkImageAspectFlags aspectMask{0};
+			ResourceUsage initialUsage{ResourceUsage::Undefined};
+			ResourceUsage finalUsage{ResourceUsage::Undefined};
+			uint32_t firstPass{~0u};
+			uint32_t lastPass{0};
+			uint32_t aliasSlot{sc_noAliasSlot};
+		};
+
+		struct ResourceState
+		{
+			VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+			VkPipelineStageFlags writeStageMask{0};
+			VkAccessFlags writeAccessMask{0};
+			VkPipelineStageFlags readStageMask{0};
+			VkPipelineStageFlags visibleStageMask{0};
+			VkAccessFlags visibleAccessMask{0};
+		};
+
+		struct FrameResources
+		{
+			size_t signature{0};
+			std::vector<VkImage> images;
+			std::vector<VkImageView> imageViews;
+			std::vector<VkBuffer> buffers;
+			std::vector<VkDeviceMemory> memories;
+		};
+
+		uint32_t addResource(const std::string &name);
+		uint32_t findResource(const std::string &name) const;
+		void addAccess(uint32_t passIndex, const std::string &name, ResourceUsage usage, bool write);
+		void cullPasses();
+		void assignAliasSlots();
+		void planBarriers();
+		void transition(uint32_t resourceIndex, const Access &access, ResourceState &state, Barrier &barrier);
+		size_t computeTransientSignature() const;
+		void allocateTransientResources(uint32_t frameIndex);
+		void destroyFrameResources(FrameResources &frameResources);
+		void recordBarrier(VkCommandBuffer commandBuffer, const Barrier &barrier) const;
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		FindMemoryTypeCb m_findMemoryTypeCb;
+		std::vector<Pass> m_passes;
+		std::vector<Resource> m_resources;
+		std::unordered_map<std::string, uint32_t> m_resourceIndices;
+		uint32_t m_aliasSlotCount{0};
+		Barrier m_finalBarrier;
+		bool m_compiled{false};
+		uint32_t m_culledPassCount{0};
+		uint32_t m_barrierCount{0};
+		std::vector<FrameResources> m_frameResources;
+		uint32_t m_frameIndex{0};
+	};
+
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef VKFW_RENDERPASSCACHE_H
+#define VKFW_RENDERPASSCACHE_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace vkfw
+{
+	constexpr uint32_t gc_maxColorAttachments = 8;
+
+	struct RenderPassAttachment
+	{
+		VkFormat format{VK_FORMAT_UNDEFINED};
+		VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+		VkAttachmentLoadOp loadOp{VK_ATTACHMENT_LOAD_OP_DONT_CARE};
+		VkAttachmentStoreOp storeOp{VK_ATTACHMENT_STORE_OP_DONT_CARE};
+		VkAttachmentLoadOp stencilLoadOp{VK_ATTACHMENT_LOAD_OP_DONT_CARE};
+		VkAttachmentStoreOp stencilStoreOp{VK_ATTACHMENT_STORE_OP_DONT_CARE};
+		VkImageLayout initialLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+		VkImageLayout finalLayout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		bool operator==(const RenderPassAttachment &other) const;
+		size_t getHash() const;
+	};
+
+	// describes a single subpass render pass.
+	// color attachments come first, followed by the (optional) depth/stencil attachment
+	struct RenderPassDescription
+	{
+		RenderPassAttachment colorAttachments[gc_maxColorAttachments];
+		uint32_t colorAttachmentCount{0};
+		RenderPassAttachment depthStencilAttachment;
+		bool hasDepthStencilAttachment{false};
+
+		bool operator==(const RenderPassDescription &other) const;
+		size_t getHash() const;
+	};
+
+	// hash-consed render passes: equal descriptions always map to the same VkRenderPass,
+	// which lives until the cache is cleared
+	class RenderPassCache
+	{
+	public:
+		RenderPassCache(VkDevice device, const VkAllocationCallbacks *allocCb);
+		~RenderPassCache();
+
+		RenderPassCache(const RenderPassCache &) = delete;
+		RenderPassCache &operator=(const RenderPassCache &) = delete;
+
+		VkRenderPass get(const RenderPassDescription &description);
+		void clear();
+
+		inline size_t getSize() const
+		{
+			return m_renderPasses.size();
+		}
+
+	private:
+		struct DescriptionHash
+		{
+			size_t operator()(const RenderPassDescription &description) const
+			{
+				return description.getHash();
+			}
+		};
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		std::unordered_map<RenderPassDescription, VkRenderPass, DescriptionHash> m_renderPasses;
+	};
+
+}
+
+#endif
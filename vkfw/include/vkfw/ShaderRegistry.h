@@ -0,0 +1,45 @@
+#ifndef VKFW_SHADERREGISTRY_H
+#define VKFW_SHADERREGISTRY_H
+
+#include <vkfw/MappedFile.h>
+#include <vkfw/vkfw.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkfw
+{
+	// entry of the table add_glsl generates when VKFW_EMBED_SPIRV is on (see cmake/glsl.cmake)
+	struct EmbeddedShader
+	{
+		const char *name;
+		const uint32_t *code;
+		size_t wordCount;
+	};
+
+	struct ShaderCode
+	{
+		const uint32_t *code{nullptr};
+		// in bytes, as VkShaderModuleCreateInfo expects
+		size_t size{0};
+	};
+
+	// looks SPIR-V up by shader name (ie.: "lambert.vert").
+	// embedded shaders are served without any file I/O, anything else is mapped once from spirv/<name>.spv
+	class ShaderRegistry
+	{
+	public:
+		void add(const EmbeddedShader *embeddedShaders, size_t count);
+		ShaderCode get(const std::string &name);
+
+	private:
+		std::unordered_map<std::string, ShaderCode> m_shaders;
+		std::vector<MappedFile> m_files;
+	};
+
+}
+
+#endif
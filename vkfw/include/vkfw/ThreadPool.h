@@ -0,0 +1,76 @@
+#ifndef VKFW_THREADPOOL_H
+#define VKFW_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vkfw
+{
+	// higher priority tasks are always dequeued first, tasks of the same priority in FIFO order
+	enum class TaskPriority
+	{
+		High,
+		Normal,
+		Low,
+		Count
+	};
+
+	// fixed set of worker threads consuming prioritized FIFOs of tasks. pending tasks are still executed on destruction
+	class ThreadPool
+	{
+	public:
+		explicit ThreadPool(uint32_t threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		template <typename TaskType>
+		auto enqueue(TaskType &&task, TaskPriority priority = TaskPriority::Normal) -> std::future<typename std::result_of<TaskType()>::type>
+		{
+			using ResultType = typename std::result_of<TaskType()>::type;
+			// std::function needs to be copyable, std::packaged_task isn't
+			auto packagedTask = std::make_shared<std::packaged_task<ResultType()>>(std::forward<TaskType>(task));
+			auto future = packagedTask->get_future();
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_tasks[(size_t)priority].emplace_back([packagedTask]()
+													   { (*packagedTask)(); });
+			}
+			m_condition.notify_one();
+			return future;
+		}
+
+		// calls function(i) for every i in [0, count) across the workers and the calling thread, returning when all calls are done.
+		// the calling thread takes work too, so it's safe to call from inside a task (even with a single worker)
+		void parallelFor(size_t count, const std::function<void(size_t)> &function, TaskPriority priority = TaskPriority::Normal);
+
+		inline uint32_t getThreadCount() const
+		{
+			return (uint32_t)m_threads.size();
+		}
+
+	private:
+		void work();
+		bool hasTasks() const;
+
+		std::vector<std::thread> m_threads;
+		std::deque<std::function<void()>> m_tasks[(size_t)TaskPriority::Count];
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stopping{false};
+	};
+
+}
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef VKFW_TRANSIENTATTACHMENTPOOL_H
+#define VKFW_TRANSIENTATTACHMENTPOOL_H
+
+#include <vkfw/vkfw.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vkfw
+{
+	// attachments whose contents never leave the render pass (ie, depth that's cleared on load and discarded on store).
+	// there's one attachment per frame in flight (not per swapchain image), created with VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT
+	// and backed by lazily allocated memory when the device offers it, so tilers may never commit memory for them at all.
+	// attachments are (re)created in VK_IMAGE_LAYOUT_UNDEFINED and their contents never carry over, so they're meant to be
+	// imported into a render graph as ResourceUsage::Undefined every frame (their first use then transitions them)
+	class TransientAttachmentPool
+	{
+	public:
+		TransientAttachmentPool(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, uint32_t frameCount);
+		~TransientAttachmentPool();
+
+		TransientAttachmentPool(const TransientAttachmentPool &) = delete;
+		TransientAttachmentPool &operator=(const TransientAttachmentPool &) = delete;
+
+		void recreate(VkFormat format, VkImageAspectFlags aspectMask, VkImageUsageFlags usage, uint32_t width, uint32_t height);
+		void destroy();
+
+		inline uint32_t getCount() const
+		{
+			return (uint32_t)m_attachments.size();
+		}
+
+		inline VkImage getImage(uint32_t frameIndex) const
+		{
+			return m_attachments[frameIndex].image;
+		}
+
+		inline VkImageView getImageView(uint32_t frameIndex) const
+		{
+			return m_attachments[frameIndex].imageView;
+		}
+
+		inline bool isLazilyAllocated() const
+		{
+			return m_lazilyAllocated;
+		}
+
+	private:
+		struct Attachment
+		{
+			VkImage image{VK_NULL_HANDLE};
+			VkImageView imageView{VK_NULL_HANDLE};
+			VkDeviceMemory memory{VK_NULL_HANDLE};
+		};
+
+		VkDevice m_device;
+		const VkAllocationCallbacks *m_allocCb;
+		FindMemoryTypeCb m_findMemoryTypeCb;
+		uint32_t m_frameCount;
+		std::vector<Attachment> m_attachments;
+		bool m_lazilyAllocated{false};
+	};
+
+}
+
+#endif
@@ -35,6 +35,7 @@
 #include <cstdint>
 #include <cassert>
 #include <fstream>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
@@ -141,6 +142,8 @@ namespace vkfw
 		}
 	}
 
+	using FindMemoryTypeCb = std::function<uint32_t(uint32_t, VkMemoryPropertyFlags)>;
+
 	struct FileData
 	{
 		std::unique_ptr<char[]> value;
@@ -176,13 +179,13 @@ namespace vkfw
 		}                                              \
 	}
 
-#define vkfwCheckResult(call)                 \
-	{                                         \
-		Result __result;                      \
-		if (!(result = call))                 \
-		{                                     \
-			vkfw::fail(result.failureReason); \
-		}                                     \
+#define vkfwCheckResult(call)                   \
+	{                                           \
+		vkfw::Result __result = call;           \
+		if (!__result)                          \
+		{                                       \
+			vkfw::fail(__result.failureReason); \
+		}                                       \
 	}
 
 #define vkfwCheckVkResult(vkCall)                           \
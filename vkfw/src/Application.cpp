@@ -6,6 +6,7 @@
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <thread>
 
 namespace
 {
@@ -107,12 +108,13 @@ namespace vkfw
 		createInstance();
 		createSurface();
 		selectPhysicalDevice();
-		getPhysicalDeviceMemoryProperties();
+		getPhysicalDevicePropertiesAndMemoryProperties();
 
 		createDeviceAndGetQueues();
 		createSwapChainAndGetImages();
 		createSynchronizationObjects();
 		createCommandPoolAndCommandBuffers();
+		createCaches();
 
 		postInitialize();
 	}
@@ -321,6 +323,32 @@ namespace vkfw
 
 		extensions.push_back("VK_KHR_swapchain");
 
+		uint32_t availableExtensionCount;
+		vkfwCheckVkResult(vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &availableExtensionCount, nullptr));
+		std::vector<VkExtensionProperties> availableExtensions(availableExtensionCount);
+		vkfwCheckVkResult(vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &availableExtensionCount, availableExtensions.data()));
+
+		m_enabledDeviceExtensions.clear();
+		for (const auto &extension : m_settings.optionalDeviceExtensions)
+		{
+			if (contains(availableExtensions, extension.c_str()))
+			{
+				m_enabledDeviceExtensions.emplace_back(extension);
+				extensions.push_back(extension.c_str());
+			}
+		}
+
+		// VkPhysicalDeviceFeatures is nothing but VkBool32s
+		VkPhysicalDeviceFeatures availableFeatures;
+		vkGetPhysicalDeviceFeatures(m_physicalDevice, &availableFeatures);
+		auto optionalFeatures = reinterpret_cast<const VkBool32 *>(&m_settings.optionalDeviceFeatures);
+		auto supportedFeatures = reinterpret_cast<const VkBool32 *>(&availableFeatures);
+		auto enabledFeatures = reinterpret_cast<VkBool32 *>(&m_enabledDeviceFeatures);
+		for (size_t i = 0; i < sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32); ++i)
+		{
+			enabledFeatures[i] = optionalFeatures[i] != VK_FALSE && supportedFeatures[i] != VK_FALSE ? VK_TRUE : VK_FALSE;
+		}
+
 		VkDeviceCreateInfo deviceCreateInfo;
 		deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 		deviceCreateInfo.pNext = nullptr;
@@ -331,7 +359,7 @@ namespace vkfw
 		deviceCreateInfo.ppEnabledExtensionNames = extensions.empty() ? nullptr : &extensions[0];
 		deviceCreateInfo.enabledLayerCount = 0;
 		deviceCreateInfo.ppEnabledLayerNames = nullptr;
-		deviceCreateInfo.pEnabledFeatures = nullptr;
+		deviceCreateInfo.pEnabledFeatures = &m_enabledDeviceFeatures;
 
 		vkfwCheckVkResult(vkCreateDevice(m_physicalDevice, &deviceCreateInfo, getAllocationCallbacks(), &m_device));
 
@@ -515,8 +543,40 @@ namespace vkfw
 		}
 	}
 
-	void Application::getPhysicalDeviceMemoryProperties()
+	void Application::createCaches()
+	{
+		m_fileReader = std::make_unique<AsyncFileReader>(std::max(m_settings.ioThreadCount, 1u));
+		auto workerThreadCount = m_settings.workerThreadCount;
+		if (workerThreadCount == 0)
+		{
+			workerThreadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+		}
+		m_threadPool = std::make_unique<ThreadPool>(workerThreadCount);
+		m_renderPassCache = std::make_unique<RenderPassCache>(m_device, getAllocationCallbacks());
+		m_framebufferCache = std::make_unique<FramebufferCache>(m_device, getAllocationCallbacks());
+		m_pipelineCache = std::make_unique<PipelineCache>(m_device, getAllocationCallbacks(), *m_threadPool);
+	}
+
+	void Application::destroyCaches()
+	{
+		m_pipelineCache = nullptr;
+		// framebuffers reference render passes
+		m_framebufferCache = nullptr;
+		m_renderPassCache = nullptr;
+		// only after the pipeline cache, which waits for the pipelines still being compiled by the workers
+		m_threadPool = nullptr;
+		// workers may be waiting on reads
+		m_fileReader = nullptr;
+	}
+
+	bool Application::isDeviceExtensionEnabled(const char *name) const
+	{
+		return std::find(m_enabledDeviceExtensions.begin(), m_enabledDeviceExtensions.end(), name) != m_enabledDeviceExtensions.end();
+	}
+
+	void Application::getPhysicalDevicePropertiesAndMemoryProperties()
 	{
+		vkGetPhysicalDeviceProperties(m_physicalDevice, &m_physicalDeviceProperties);
 		vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_physicalDeviceMemoryProperties);
 	}
 
@@ -725,6 +785,7 @@ namespace vkfw
 
 	void Application::finalize()
 	{
+		destroyCaches();
 		destroyCommandPoolAndCommandBuffers();
 		destroySynchronizationObjects();
 		destroySwapChainAndClearImages();
@@ -770,7 +831,7 @@ namespace vkfw
 
 	void Application::present()
 	{
-		VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		VkPipelineStageFlags waitDstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 		VkSubmitInfo submitInfo;
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.pNext = nullptr;
@@ -823,6 +884,9 @@ namespace vkfw
 		m_width = width;
 		m_height = height;
 
+		// swapchain images (and whatever the application built on top of them) may still be in use by frames in flight
+		vkDeviceWaitIdle(m_device);
+
 		recreateSwapChainAndGetImages();
 
 		postResize(width, height);
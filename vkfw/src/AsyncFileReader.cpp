@@ -0,0 +1,52 @@
+#include <vkfw/AsyncFileReader.h>
+
+namespace
+{
+	// smallest page size we care about, touching more often than needed is harmless
+	constexpr size_t gc_pageSize = 4096;
+
+	vkfw::MappedFile load(const std::string &filename, vkfw::FileAccessPattern accessPattern)
+	{
+		vkfw::MappedFile mappedFile(filename, accessPattern);
+		const volatile char *data = mappedFile.getData();
+		for (size_t i = 0; i < mappedFile.getSize(); i += gc_pageSize)
+		{
+			(void)data[i];
+		}
+		return mappedFile;
+	}
+
+}
+
+namespace vkfw
+{
+	AsyncFileReader::AsyncFileReader(uint32_t threadCount) : m_threadPool(threadCount)
+	{
+	}
+
+	std::future<MappedFile> AsyncFileReader::read(const std::string &filename, TaskPriority priority, FileAccessPattern accessPattern)
+	{
+		return m_threadPool.enqueue([filename, accessPattern]()
+									{ return load(filename, accessPattern); },
+									priority);
+	}
+
+	std::vector<std::future<MappedFile>> AsyncFileReader::read(const std::vector<std::string> &filenames, TaskPriority priority, FileAccessPattern accessPattern)
+	{
+		std::vector<std::future<MappedFile>> mappedFiles;
+		mappedFiles.reserve(filenames.size());
+		for (const auto &filename : filenames)
+		{
+			mappedFiles.emplace_back(read(filename, priority, accessPattern));
+		}
+		return mappedFiles;
+	}
+
+	void AsyncFileReader::read(const std::string &filename, CompletionCb callback, TaskPriority priority, FileAccessPattern accessPattern)
+	{
+		m_threadPool.enqueue([filename, callback, accessPattern]()
+							 { callback(load(filename, accessPattern)); },
+							 priority);
+	}
+
+}
@@ -0,0 +1,109 @@
+#include <vkfw/FramebufferCache.h>
+#include <vkfw/Hash.h>
+
+#include <algorithm>
+
+namespace vkfw
+{
+	bool FramebufferDescription::operator==(const FramebufferDescription &other) const
+	{
+		return renderPass == other.renderPass &&
+			   attachmentCount == other.attachmentCount &&
+			   std::equal(attachments, attachments + attachmentCount, other.attachments) &&
+			   width == other.width &&
+			   height == other.height &&
+			   layers == other.layers;
+	}
+
+	size_t FramebufferDescription::getHash() const
+	{
+		size_t hash = 0;
+		hashCombine(hash, renderPass, attachmentCount, width, height, layers);
+		for (uint32_t i = 0; i < attachmentCount; ++i)
+		{
+			hashCombine(hash, attachments[i]);
+		}
+		return hash;
+	}
+
+	FramebufferCache::FramebufferCache(VkDevice device, const VkAllocationCallbacks *allocCb) : m_device(device),
+																								m_allocCb(allocCb)
+	{
+	}
+
+	FramebufferCache::~FramebufferCache()
+	{
+		clear();
+	}
+
+	VkFramebuffer FramebufferCache::get(const FramebufferDescription &description)
+	{
+		if (description.attachmentCount > gc_maxFramebufferAttachments)
+		{
+			fail("too many framebuffer attachments (%d)", description.attachmentCount);
+		}
+
+		auto it = m_framebuffers.find(description);
+		if (it != m_framebuffers.end())
+		{
+			return it->second;
+		}
+
+		VkFramebufferCreateInfo framebufferCreateInfo;
+		framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.pNext = nullptr;
+		framebufferCreateInfo.flags = 0;
+		framebufferCreateInfo.renderPass = description.renderPass;
+		framebufferCreateInfo.attachmentCount = description.attachmentCount;
+		framebufferCreateInfo.pAttachments = description.attachmentCount > 0 ? description.attachments : nullptr;
+		framebufferCreateInfo.width = description.width;
+		framebufferCreateInfo.height = description.height;
+		framebufferCreateInfo.layers = description.layers;
+
+		VkFramebuffer framebuffer;
+		vkfwCheckVkResult(vkCreateFramebuffer(m_device, &framebufferCreateInfo, m_allocCb, &framebuffer));
+
+		m_framebuffers.emplace(description, framebuffer);
+
+		return framebuffer;
+	}
+
+	template <typename PredicateType>
+	void FramebufferCache::evictIf(PredicateType predicate)
+	{
+		for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();)
+		{
+			if (predicate(it->first))
+			{
+				vkDestroyFramebuffer(m_device, it->second, m_allocCb);
+				it = m_framebuffers.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void FramebufferCache::evictImageView(VkImageView imageView)
+	{
+		evictIf([imageView](const FramebufferDescription &description)
+				{ return std::find(description.attachments, description.attachments + description.attachmentCount, imageView) != description.attachments + description.attachmentCount; });
+	}
+
+	void FramebufferCache::evictRenderPass(VkRenderPass renderPass)
+	{
+		evictIf([renderPass](const FramebufferDescription &description)
+				{ return description.renderPass == renderPass; });
+	}
+
+	void FramebufferCache::clear()
+	{
+		for (auto &entry : m_framebuffers)
+		{
+			vkDestroyFramebuffer(m_device, entry.second, m_allocCb);
+		}
+		m_framebuffers.clear();
+	}
+
+}
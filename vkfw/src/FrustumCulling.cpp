@@ -0,0 +1,151 @@
+#include <vkfw/FrustumCulling.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define VKFW_CULLING_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vkfw
+{
+	namespace
+	{
+		// bounds tested at once, every stream is padded to a multiple of it
+		constexpr size_t gc_simdWidth = 4;
+		// per task (a multiple of gc_simdWidth), fewer bounds than that are culled on the calling thread alone
+		constexpr size_t gc_cullBatchSize = 16384;
+
+	}
+
+	Frustum extractFrustum(const float clip[16])
+	{
+		Frustum frustum;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			auto x = clip[i * 4], y = clip[i * 4 + 1], z = clip[i * 4 + 2], w = clip[i * 4 + 3];
+			frustum.planes[0][i] = w + x;
+			frustum.planes[1][i] = w - x;
+			frustum.planes[2][i] = w + y;
+			frustum.planes[3][i] = w - y;
+			frustum.planes[4][i] = z;
+			frustum.planes[5][i] = w - z;
+		}
+		for (auto &plane : frustum.planes)
+		{
+			auto length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			for (uint32_t k = 0; k < 4; ++k)
+			{
+				plane[k] /= length;
+			}
+		}
+		return frustum;
+	}
+
+	size_t BoundingVolumes::add(const float boundsMin[3], const float boundsMax[3], float radius)
+	{
+		if (m_count % gc_simdWidth == 0)
+		{
+			for (auto &stream : m_streams)
+			{
+				stream.resize(m_count + gc_simdWidth, 0);
+			}
+		}
+		for (uint32_t k = 0; k < 3; ++k)
+		{
+			m_streams[CenterX + k][m_count] = (boundsMin[k] + boundsMax[k]) * 0.5f;
+			m_streams[ExtentX + k][m_count] = (boundsMax[k] - boundsMin[k]) * 0.5f;
+		}
+		m_streams[Radius][m_count] = radius;
+		return m_count++;
+	}
+
+	void BoundingVolumes::clear()
+	{
+		for (auto &stream : m_streams)
+		{
+			stream.clear();
+		}
+		m_count = 0;
+	}
+
+	void BoundingVolumes::cull(const Frustum &frustum, uint8_t *visibility, ThreadPool *threadPool) const
+	{
+		auto batchCount = (m_count + gc_cullBatchSize - 1) / gc_cullBatchSize;
+		if (threadPool == nullptr || batchCount < 2)
+		{
+			cullRange(frustum, 0, m_count, visibility);
+			return;
+		}
+		// high priority, since the frame waits on it
+		threadPool->parallelFor(
+			batchCount, [this, &frustum, visibility](size_t batch)
+			{
+				auto first = batch * gc_cullBatchSize;
+				cullRange(frustum, first, std::min(first + gc_cullBatchSize, m_count), visibility); },
+			TaskPriority::High);
+	}
+
+	// a box is outside of a plane if its center is further out than its projected extent (|n| . extent), a sphere if it's further out than its radius.
+	// the bounds are outside of the frustum if either is outside of any plane, so every plane is tested against the smaller of the two
+	void BoundingVolumes::cullRange(const Frustum &frustum, size_t first, size_t last, uint8_t *visibility) const
+	{
+		const auto *centerX = m_streams[CenterX].data(), *centerY = m_streams[CenterY].data(), *centerZ = m_streams[CenterZ].data();
+		const auto *extentX = m_streams[ExtentX].data(), *extentY = m_streams[ExtentY].data(), *extentZ = m_streams[ExtentZ].data();
+		const auto *radius = m_streams[Radius].data();
+#if defined VKFW_CULLING_SSE2
+		const auto signMask = _mm_set1_ps(-0.0f);
+		__m128 planes[6][4], absoluteNormals[6][3];
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			for (uint32_t k = 0; k < 4; ++k)
+			{
+				planes[i][k] = _mm_set1_ps(frustum.planes[i][k]);
+			}
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				absoluteNormals[i][k] = _mm_andnot_ps(signMask, planes[i][k]);
+			}
+		}
+
+		// first is a multiple of the simd width and the streams are padded, so the last batch can be loaded whole
+		for (auto i = first; i < last; i += gc_simdWidth)
+		{
+			auto x = _mm_loadu_ps(centerX + i), y = _mm_loadu_ps(centerY + i), z = _mm_loadu_ps(centerZ + i);
+			auto ex = _mm_loadu_ps(extentX + i), ey = _mm_loadu_ps(extentY + i), ez = _mm_loadu_ps(extentZ + i);
+			auto r = _mm_loadu_ps(radius + i);
+
+			auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (uint32_t j = 0; j < 6; ++j)
+			{
+				auto distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[j][0], x), _mm_mul_ps(planes[j][1], y)), _mm_add_ps(_mm_mul_ps(planes[j][2], z), planes[j][3]));
+				auto projectedExtent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(absoluteNormals[j][0], ex), _mm_mul_ps(absoluteNormals[j][1], ey)), _mm_mul_ps(absoluteNormals[j][2], ez));
+				// distance >= -min(extent, radius)
+				auto limit = _mm_xor_ps(_mm_min_ps(projectedExtent, r), signMask);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, limit));
+			}
+
+			auto mask = _mm_movemask_ps(inside);
+			auto count = std::min(gc_simdWidth, last - i);
+			for (size_t k = 0; k < count; ++k)
+			{
+				visibility[i + k] = (uint8_t)((mask >> k) & 1);
+			}
+		}
+#else
+		for (auto i = first; i < last; ++i)
+		{
+			uint8_t inside = 1;
+			for (const auto &plane : frustum.planes)
+			{
+				auto distance = plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i] + plane[3];
+				auto projectedExtent = std::abs(plane[0]) * extentX[i] + std::abs(plane[1]) * extentY[i] + std::abs(plane[2]) * extentZ[i];
+				inside &= (uint8_t)(distance >= -std::min(projectedExtent, radius[i]));
+			}
+			visibility[i] = inside;
+		}
+#endif
+	}
+
+}
@@ -0,0 +1,104 @@
+#include <vkfw/GeometryArena.h>
+
+#include <algorithm>
+
+namespace vkfw
+{
+	namespace
+	{
+		constexpr VkDeviceSize gc_indexAlignment = 4;
+
+		inline VkDeviceSize alignUp(VkDeviceSize offset, VkDeviceSize alignment)
+		{
+			return (offset + alignment - 1) / alignment * alignment;
+		}
+
+	}
+
+	GeometryArena::GeometryArena(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, VkDeviceSize vertexBlockSize, VkDeviceSize indexBlockSize) : m_device(device),
+																																														  m_allocCb(allocCb),
+																																														  m_findMemoryTypeCb(std::move(findMemoryTypeCb)),
+																																														  m_vertexBlockSize(vertexBlockSize),
+																																														  m_indexBlockSize(indexBlockSize)
+	{
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		clear();
+	}
+
+	GeometryAllocation GeometryArena::allocate(VkDeviceSize vertexCount, VkDeviceSize vertexStride, VkDeviceSize indexCount, VkDeviceSize indexSize)
+	{
+		auto vertexBufferSize = vertexCount * vertexStride;
+		auto indexBufferSize = indexCount * indexSize;
+
+		auto fits = [vertexStride, vertexBufferSize, indexBufferSize](const Block &block)
+		{
+			return alignUp(block.usedVertexBufferSize, vertexStride) + vertexBufferSize <= block.vertexBufferSize &&
+				   alignUp(block.usedIndexBufferSize, gc_indexAlignment) + indexBufferSize <= block.indexBufferSize;
+		};
+
+		if (m_blocks.empty() || !fits(m_blocks.back()))
+		{
+			Block block;
+			// vertex offsets have to be multiples of any stride, so blocks start at 0
+			block.vertexBufferSize = std::max(m_vertexBlockSize, vertexBufferSize);
+			block.indexBufferSize = std::max(m_indexBlockSize, indexBufferSize);
+			createBuffer(block.vertexBufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, block.vertexBuffer, block.vertexMemory);
+			createBuffer(block.indexBufferSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, block.indexBuffer, block.indexMemory);
+			m_blocks.emplace_back(block);
+		}
+
+		auto &block = m_blocks.back();
+		GeometryAllocation allocation;
+		allocation.block = (uint32_t)m_blocks.size() - 1;
+		allocation.vertexBufferOffset = alignUp(block.usedVertexBufferSize, vertexStride);
+		allocation.indexBufferOffset = alignUp(block.usedIndexBufferSize, gc_indexAlignment);
+		allocation.vertexOffset = (uint32_t)(allocation.vertexBufferOffset / vertexStride);
+		allocation.firstIndex = (uint32_t)(allocation.indexBufferOffset / indexSize);
+		block.usedVertexBufferSize = allocation.vertexBufferOffset + vertexBufferSize;
+		block.usedIndexBufferSize = allocation.indexBufferOffset + indexBufferSize;
+		return allocation;
+	}
+
+	void GeometryArena::clear()
+	{
+		for (auto &block : m_blocks)
+		{
+			vkDestroyBuffer(m_device, block.vertexBuffer, m_allocCb);
+			vkFreeMemory(m_device, block.vertexMemory, m_allocCb);
+			vkDestroyBuffer(m_device, block.indexBuffer, m_allocCb);
+			vkFreeMemory(m_device, block.indexMemory, m_allocCb);
+		}
+		m_blocks.clear();
+	}
+
+	void GeometryArena::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkBuffer &buffer, VkDeviceMemory &memory)
+	{
+		VkBufferCreateInfo bufferCreateInfo;
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.pNext = nullptr;
+		bufferCreateInfo.flags = 0;
+		bufferCreateInfo.size = size;
+		bufferCreateInfo.usage = usage;
+		bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		bufferCreateInfo.queueFamilyIndexCount = 0;
+		bufferCreateInfo.pQueueFamilyIndices = nullptr;
+
+		vkfwCheckVkResult(vkCreateBuffer(m_device, &bufferCreateInfo, m_allocCb, &buffer));
+
+		VkMemoryRequirements memoryRequirements;
+		vkGetBufferMemoryRequirements(m_device, buffer, &memoryRequirements);
+
+		VkMemoryAllocateInfo memoryAllocateInfo;
+		memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		memoryAllocateInfo.pNext = nullptr;
+		memoryAllocateInfo.allocationSize = memoryRequirements.size;
+		memoryAllocateInfo.memoryTypeIndex = m_findMemoryTypeCb(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		vkfwCheckVkResult(vkAllocateMemory(m_device, &memoryAllocateInfo, m_allocCb, &memory));
+		vkfwCheckVkResult(vkBindBufferMemory(m_device, buffer, memory, 0));
+	}
+
+}
@@ -0,0 +1,256 @@
+#include <vkfw/GraphicsPipelineDescription.h>
+#include <vkfw/Hash.h>
+
+#include <cstring>
+
+namespace
+{
+	bool operator==(const VkVertexInputBindingDescription &a, const VkVertexInputBindingDescription &b)
+	{
+		return a.binding == b.binding && a.stride == b.stride && a.inputRate == b.inputRate;
+	}
+
+	bool operator==(const VkVertexInputAttributeDescription &a, const VkVertexInputAttributeDescription &b)
+	{
+		return a.location == b.location && a.binding == b.binding && a.format == b.format && a.offset == b.offset;
+	}
+
+	bool operator==(const VkSpecializationMapEntry &a, const VkSpecializationMapEntry &b)
+	{
+		return a.constantID == b.constantID && a.offset == b.offset && a.size == b.size;
+	}
+
+	bool operator==(const VkPipelineColorBlendAttachmentState &a, const VkPipelineColorBlendAttachmentState &b)
+	{
+		return a.blendEnable == b.blendEnable &&
+			   a.srcColorBlendFactor == b.srcColorBlendFactor &&
+			   a.dstColorBlendFactor == b.dstColorBlendFactor &&
+			   a.colorBlendOp == b.colorBlendOp &&
+			   a.srcAlphaBlendFactor == b.srcAlphaBlendFactor &&
+			   a.dstAlphaBlendFactor == b.dstAlphaBlendFactor &&
+			   a.alphaBlendOp == b.alphaBlendOp &&
+			   a.colorWriteMask == b.colorWriteMask;
+	}
+
+	template <typename ElementType>
+	bool equal(const ElementType *a, const ElementType *b, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (!(a[i] == b[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
+
+namespace vkfw
+{
+	bool SpecializationConstants::operator==(const SpecializationConstants &other) const
+	{
+		return mapEntryCount == other.mapEntryCount &&
+			   equal(mapEntries, other.mapEntries, mapEntryCount) &&
+			   dataSize == other.dataSize &&
+			   memcmp(data, other.data, dataSize) == 0;
+	}
+
+	void SpecializationConstants::hash(size_t &hash) const
+	{
+		hashCombine(hash, mapEntryCount);
+		for (uint32_t i = 0; i < mapEntryCount; ++i)
+		{
+			const auto &mapEntry = mapEntries[i];
+			hashCombine(hash, mapEntry.constantID, mapEntry.offset, mapEntry.size);
+		}
+		hashCombine(hash, dataSize);
+		for (uint32_t i = 0; i < dataSize; ++i)
+		{
+			hashCombine(hash, data[i]);
+		}
+	}
+
+	bool GraphicsPipelineDescription::operator==(const GraphicsPipelineDescription &other) const
+	{
+		return layout == other.layout &&
+			   renderPass == other.renderPass &&
+			   subpass == other.subpass &&
+			   vertexShader == other.vertexShader &&
+			   fragmentShader == other.fragmentShader &&
+			   vertexSpecialization == other.vertexSpecialization &&
+			   fragmentSpecialization == other.fragmentSpecialization &&
+			   vertexBindingCount == other.vertexBindingCount &&
+			   equal(vertexBindings, other.vertexBindings, vertexBindingCount) &&
+			   vertexAttributeCount == other.vertexAttributeCount &&
+			   equal(vertexAttributes, other.vertexAttributes, vertexAttributeCount) &&
+			   topology == other.topology &&
+			   polygonMode == other.polygonMode &&
+			   cullMode == other.cullMode &&
+			   frontFace == other.frontFace &&
+			   samples == other.samples &&
+			   depthTestEnable == other.depthTestEnable &&
+			   depthWriteEnable == other.depthWriteEnable &&
+			   depthCompareOp == other.depthCompareOp &&
+			   colorBlendAttachmentCount == other.colorBlendAttachmentCount &&
+			   equal(colorBlendAttachments, other.colorBlendAttachments, colorBlendAttachmentCount);
+	}
+
+	// field by field (never over the raw bytes, which include padding), and only over the used part of the arrays
+	size_t GraphicsPipelineDescription::getHash() const
+	{
+		size_t hash = 0;
+		hashCombine(hash, layout, renderPass, subpass, vertexShader, fragmentShader);
+		vertexSpecialization.hash(hash);
+		fragmentSpecialization.hash(hash);
+		hashCombine(hash, vertexBindingCount);
+		for (uint32_t i = 0; i < vertexBindingCount; ++i)
+		{
+			const auto &vertexBinding = vertexBindings[i];
+			hashCombine(hash, vertexBinding.binding, vertexBinding.stride, vertexBinding.inputRate);
+		}
+		hashCombine(hash, vertexAttributeCount);
+		for (uint32_t i = 0; i < vertexAttributeCount; ++i)
+		{
+			const auto &vertexAttribute = vertexAttributes[i];
+			hashCombine(hash, vertexAttribute.location, vertexAttribute.binding, vertexAttribute.format, vertexAttribute.offset);
+		}
+		hashCombine(hash, topology, polygonMode, cullMode, frontFace, samples, depthTestEnable, depthWriteEnable, depthCompareOp);
+		hashCombine(hash, colorBlendAttachmentCount);
+		for (uint32_t i = 0; i < colorBlendAttachmentCount; ++i)
+		{
+			const auto &colorBlendAttachment = colorBlendAttachments[i];
+			hashCombine(hash, colorBlendAttachment.blendEnable, colorBlendAttachment.srcColorBlendFactor, colorBlendAttachment.dstColorBlendFactor, colorBlendAttachment.colorBlendOp);
+			hashCombine(hash, colorBlendAttachment.srcAlphaBlendFactor, colorBlendAttachment.dstAlphaBlendFactor, colorBlendAttachment.alphaBlendOp, colorBlendAttachment.colorWriteMask);
+		}
+		return hash;
+	}
+
+	GraphicsPipelineBuilder::GraphicsPipelineBuilder(VkPipelineLayout layout, VkRenderPass renderPass, uint32_t subpass)
+	{
+		m_description.layout = layout;
+		m_description.renderPass = renderPass;
+		m_description.subpass = subpass;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setShaders(VkShaderModule vertexShader, VkShaderModule fragmentShader)
+	{
+		m_description.vertexShader = vertexShader;
+		m_description.fragmentShader = fragmentShader;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setSpecialization(VkShaderStageFlagBits stage, const void *data, uint32_t dataSize, const VkSpecializationMapEntry *mapEntries, uint32_t mapEntryCount)
+	{
+		SpecializationConstants *specialization;
+		switch (stage)
+		{
+		case VK_SHADER_STAGE_VERTEX_BIT:
+			specialization = &m_description.vertexSpecialization;
+			break;
+		case VK_SHADER_STAGE_FRAGMENT_BIT:
+			specialization = &m_description.fragmentSpecialization;
+			break;
+		default:
+			fail("unsupported shader stage for specialization");
+			return *this;
+		}
+		if (dataSize > gc_maxSpecializationDataSize)
+		{
+			fail("specialization constants are too big");
+		}
+		if (mapEntryCount > gc_maxSpecializationMapEntries)
+		{
+			fail("too many specialization map entries");
+		}
+
+		*specialization = {};
+		for (uint32_t i = 0; i < mapEntryCount; ++i)
+		{
+			const auto &mapEntry = mapEntries[i];
+			if (mapEntry.offset + mapEntry.size > dataSize)
+			{
+				fail("specialization map entry %u is out of bounds", mapEntry.constantID);
+			}
+			memcpy(specialization->data + mapEntry.offset, (const uint8_t *)data + mapEntry.offset, mapEntry.size);
+			specialization->mapEntries[i] = mapEntry;
+		}
+		specialization->mapEntryCount = mapEntryCount;
+		specialization->dataSize = dataSize;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::addVertexBinding(uint32_t binding, uint32_t stride, VkVertexInputRate inputRate)
+	{
+		if (m_description.vertexBindingCount == gc_maxVertexBindings)
+		{
+			fail("too many vertex bindings");
+		}
+		m_description.vertexBindings[m_description.vertexBindingCount++] = {binding, stride, inputRate};
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::addVertexAttribute(uint32_t location, uint32_t binding, VkFormat format, uint32_t offset)
+	{
+		if (m_description.vertexAttributeCount == gc_maxVertexAttributes)
+		{
+			fail("too many vertex attributes");
+		}
+		m_description.vertexAttributes[m_description.vertexAttributeCount++] = {location, binding, format, offset};
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setTopology(VkPrimitiveTopology topology)
+	{
+		m_description.topology = topology;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setRasterization(VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace)
+	{
+		m_description.polygonMode = polygonMode;
+		m_description.cullMode = cullMode;
+		m_description.frontFace = frontFace;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setSamples(VkSampleCountFlagBits samples)
+	{
+		m_description.samples = samples;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::setDepthTest(bool depthWriteEnable, VkCompareOp depthCompareOp)
+	{
+		m_description.depthTestEnable = true;
+		m_description.depthWriteEnable = depthWriteEnable;
+		m_description.depthCompareOp = depthCompareOp;
+		return *this;
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::addColorAttachment()
+	{
+		VkPipelineColorBlendAttachmentState colorBlendAttachmentState;
+		colorBlendAttachmentState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		colorBlendAttachmentState.blendEnable = VK_FALSE;
+		colorBlendAttachmentState.srcColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachmentState.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachmentState.colorBlendOp = VK_BLEND_OP_ADD;
+		colorBlendAttachmentState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachmentState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachmentState.alphaBlendOp = VK_BLEND_OP_ADD;
+		return addColorAttachment(colorBlendAttachmentState);
+	}
+
+	GraphicsPipelineBuilder &GraphicsPipelineBuilder::addColorAttachment(const VkPipelineColorBlendAttachmentState &colorBlendAttachmentState)
+	{
+		if (m_description.colorBlendAttachmentCount == gc_maxColorAttachments)
+		{
+			fail("too many color attachments");
+		}
+		m_description.colorBlendAttachments[m_description.colorBlendAttachmentCount++] = colorBlendAttachmentState;
+		return *this;
+	}
+
+}
@@ -0,0 +1,134 @@
+#include <vkfw/MappedFile.h>
+
+#if defined vkfwLinux
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace vkfw
+{
+#if defined vkfwWindows
+	MappedFile::MappedFile(const std::string &filename, FileAccessPattern accessPattern)
+	{
+		auto flags = accessPattern == FileAccessPattern::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+		auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return;
+		}
+		m_size = (size_t)fileSize.QuadPart;
+
+		if (m_size > 0)
+		{
+			auto fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (fileMapping != nullptr)
+			{
+				m_data = static_cast<const char *>(MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0));
+				// the view keeps the mapping (and the file) alive
+				CloseHandle(fileMapping);
+			}
+			if (m_data == nullptr)
+			{
+				m_size = 0;
+				CloseHandle(file);
+				return;
+			}
+		}
+		CloseHandle(file);
+		m_open = true;
+	}
+
+	void MappedFile::unmap()
+	{
+		if (m_data != nullptr)
+		{
+			UnmapViewOfFile(m_data);
+		}
+	}
+#elif defined vkfwLinux
+	MappedFile::MappedFile(const std::string &filename, FileAccessPattern accessPattern)
+	{
+		auto file = open(filename.c_str(), O_RDONLY);
+		if (file == -1)
+		{
+			return;
+		}
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) == -1)
+		{
+			close(file);
+			return;
+		}
+		m_size = (size_t)fileStat.st_size;
+
+		if (m_size > 0)
+		{
+			auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED)
+			{
+				m_size = 0;
+				close(file);
+				return;
+			}
+			// hints only, failures are harmless
+			if (accessPattern == FileAccessPattern::Sequential)
+			{
+				madvise(data, m_size, MADV_SEQUENTIAL);
+				madvise(data, m_size, MADV_WILLNEED);
+			}
+			else
+			{
+				madvise(data, m_size, MADV_RANDOM);
+			}
+			m_data = static_cast<const char *>(data);
+		}
+		// the mapping keeps the file alive
+		close(file);
+		m_open = true;
+	}
+
+	void MappedFile::unmap()
+	{
+		if (m_data != nullptr)
+		{
+			munmap(const_cast<char *>(m_data), m_size);
+		}
+	}
+#endif
+
+	MappedFile::~MappedFile()
+	{
+		unmap();
+	}
+
+	MappedFile::MappedFile(MappedFile &&other) noexcept : m_data(std::exchange(other.m_data, nullptr)),
+														  m_size(std::exchange(other.m_size, 0)),
+														  m_open(std::exchange(other.m_open, false))
+	{
+	}
+
+	MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+			m_open = std::exchange(other.m_open, false);
+		}
+		return *this;
+	}
+
+}
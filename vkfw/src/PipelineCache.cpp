@@ -0,0 +1,344 @@
+#include <vkfw/PipelineCache.h>
+
+#include <chrono>
+
+namespace
+{
+	const VkDynamicState gc_dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+	// everything a VkGraphicsPipelineCreateInfo points to
+	struct GraphicsPipelineCreateInfoStorage
+	{
+		VkPipelineShaderStageCreateInfo shaderStages[2];
+		VkSpecializationInfo specializationInfos[2];
+		VkPipelineDynamicStateCreateInfo dynamicState;
+		VkPipelineVertexInputStateCreateInfo vertexInputState;
+		VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+		VkViewport viewport;
+		VkRect2D scissorRect;
+		VkPipelineViewportStateCreateInfo viewportState;
+		VkPipelineRasterizationStateCreateInfo rasterizationState;
+		VkPipelineMultisampleStateCreateInfo multisampleState;
+		VkPipelineColorBlendStateCreateInfo colorBlendState;
+		VkPipelineDepthStencilStateCreateInfo depthStencilState;
+	};
+
+	void initShaderStageCreateInfo(VkShaderModule module, VkShaderStageFlagBits stage, const vkfw::SpecializationConstants &specialization, VkSpecializationInfo &specializationInfo, VkPipelineShaderStageCreateInfo &shaderStageCreateInfo)
+	{
+		specializationInfo.mapEntryCount = specialization.mapEntryCount;
+		specializationInfo.pMapEntries = specialization.mapEntries;
+		specializationInfo.dataSize = specialization.dataSize;
+		specializationInfo.pData = specialization.data;
+
+		shaderStageCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStageCreateInfo.pNext = nullptr;
+		shaderStageCreateInfo.flags = 0;
+		shaderStageCreateInfo.module = module;
+		shaderStageCreateInfo.stage = stage;
+		shaderStageCreateInfo.pName = "main";
+		shaderStageCreateInfo.pSpecializationInfo = specialization.mapEntryCount > 0 ? &specializationInfo : nullptr;
+	}
+
+	void initGraphicsPipelineCreateInfo(const vkfw::GraphicsPipelineDescription &description, GraphicsPipelineCreateInfoStorage &storage, VkGraphicsPipelineCreateInfo &graphicsPipelineCreateInfo)
+	{
+		graphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		graphicsPipelineCreateInfo.pNext = nullptr;
+		graphicsPipelineCreateInfo.flags = 0;
+
+		graphicsPipelineCreateInfo.layout = description.layout;
+		graphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+		graphicsPipelineCreateInfo.basePipelineIndex = 0;
+		graphicsPipelineCreateInfo.renderPass = description.renderPass;
+		graphicsPipelineCreateInfo.subpass = description.subpass;
+
+		initShaderStageCreateInfo(description.vertexShader, VK_SHADER_STAGE_VERTEX_BIT, description.vertexSpecialization, storage.specializationInfos[0], storage.shaderStages[0]);
+		initShaderStageCreateInfo(description.fragmentShader, VK_SHADER_STAGE_FRAGMENT_BIT, description.fragmentSpecialization, storage.specializationInfos[1], storage.shaderStages[1]);
+		graphicsPipelineCreateInfo.stageCount = vkfwArraySize(storage.shaderStages);
+		graphicsPipelineCreateInfo.pStages = storage.shaderStages;
+
+		auto &dynamicStateCreateInfo = storage.dynamicState;
+		dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicStateCreateInfo.pNext = nullptr;
+		dynamicStateCreateInfo.flags = 0;
+		dynamicStateCreateInfo.dynamicStateCount = vkfwArraySize(gc_dynamicStates);
+		dynamicStateCreateInfo.pDynamicStates = gc_dynamicStates;
+		graphicsPipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
+
+		auto &vertexInputStateCreateInfo = storage.vertexInputState;
+		vertexInputStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInputStateCreateInfo.pNext = nullptr;
+		vertexInputStateCreateInfo.flags = 0;
+		vertexInputStateCreateInfo.vertexBindingDescriptionCount = description.vertexBindingCount;
+		vertexInputStateCreateInfo.pVertexBindingDescriptions = description.vertexBindingCount > 0 ? description.vertexBindings : nullptr;
+		vertexInputStateCreateInfo.vertexAttributeDescriptionCount = description.vertexAttributeCount;
+		vertexInputStateCreateInfo.pVertexAttributeDescriptions = description.vertexAttributeCount > 0 ? description.vertexAttributes : nullptr;
+		graphicsPipelineCreateInfo.pVertexInputState = &vertexInputStateCreateInfo;
+
+		auto &inputAssemblyStateCreateInfo = storage.inputAssemblyState;
+		inputAssemblyStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssemblyStateCreateInfo.pNext = nullptr;
+		inputAssemblyStateCreateInfo.flags = 0;
+		inputAssemblyStateCreateInfo.topology = description.topology;
+		inputAssemblyStateCreateInfo.primitiveRestartEnable = VK_FALSE;
+		graphicsPipelineCreateInfo.pInputAssemblyState = &inputAssemblyStateCreateInfo;
+
+		storage.viewport = {};
+		storage.scissorRect = {};
+
+		auto &viewportStateCreateInfo = storage.viewportState;
+		viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportStateCreateInfo.pNext = nullptr;
+		viewportStateCreateInfo.flags = 0;
+		// even though we define viewport and scissor as dynamic states, we need to setup them
+		// cause spec states that if the multiple viewports feature is not enabled, viewportCount/scissorCount must be 1
+		// source: https://www.khronos.org/registry/vulkan/specs/1.1-extensions/html/vkspec.html#VUID-VkPipelineViewportStateCreateInfo-viewportCount-01216
+		viewportStateCreateInfo.viewportCount = 1;
+		viewportStateCreateInfo.pViewports = &storage.viewport;
+		viewportStateCreateInfo.scissorCount = 1;
+		viewportStateCreateInfo.pScissors = &storage.scissorRect;
+		graphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
+
+		auto &rasterizationStateCreateInfo = storage.rasterizationState;
+		rasterizationStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizationStateCreateInfo.pNext = nullptr;
+		rasterizationStateCreateInfo.flags = 0;
+		rasterizationStateCreateInfo.depthClampEnable = VK_FALSE;
+		rasterizationStateCreateInfo.rasterizerDiscardEnable = VK_FALSE;
+		rasterizationStateCreateInfo.polygonMode = description.polygonMode;
+		rasterizationStateCreateInfo.cullMode = description.cullMode;
+		rasterizationStateCreateInfo.frontFace = description.frontFace;
+		rasterizationStateCreateInfo.depthBiasEnable = VK_FALSE;
+		rasterizationStateCreateInfo.depthBiasConstantFactor = 0;
+		rasterizationStateCreateInfo.depthBiasClamp = 0;
+		rasterizationStateCreateInfo.depthBiasSlopeFactor = 0;
+		rasterizationStateCreateInfo.lineWidth = 1;
+		graphicsPipelineCreateInfo.pRasterizationState = &rasterizationStateCreateInfo;
+
+		auto &multisampleStateCreateInfo = storage.multisampleState;
+		multisampleStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampleStateCreateInfo.pNext = nullptr;
+		multisampleStateCreateInfo.flags = 0;
+		multisampleStateCreateInfo.rasterizationSamples = description.samples;
+		multisampleStateCreateInfo.sampleShadingEnable = VK_FALSE;
+		multisampleStateCreateInfo.minSampleShading = 0;
+		multisampleStateCreateInfo.pSampleMask = nullptr;
+		multisampleStateCreateInfo.alphaToCoverageEnable = VK_FALSE;
+		multisampleStateCreateInfo.alphaToOneEnable = VK_FALSE;
+		graphicsPipelineCreateInfo.pMultisampleState = &multisampleStateCreateInfo;
+
+		auto &colorBlendStateCreateInfo = storage.colorBlendState;
+		colorBlendStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlendStateCreateInfo.pNext = nullptr;
+		colorBlendStateCreateInfo.flags = 0;
+		colorBlendStateCreateInfo.logicOpEnable = VK_FALSE;
+		colorBlendStateCreateInfo.logicOp = VK_LOGIC_OP_CLEAR;
+		colorBlendStateCreateInfo.attachmentCount = description.colorBlendAttachmentCount;
+		colorBlendStateCreateInfo.pAttachments = description.colorBlendAttachmentCount > 0 ? description.colorBlendAttachments : nullptr;
+		colorBlendStateCreateInfo.blendConstants[0] = 0;
+		colorBlendStateCreateInfo.blendConstants[1] = 0;
+		colorBlendStateCreateInfo.blendConstants[2] = 0;
+		colorBlendStateCreateInfo.blendConstants[3] = 0;
+		graphicsPipelineCreateInfo.pColorBlendState = &colorBlendStateCreateInfo;
+
+		auto &depthStencilStateCreateInfo = storage.depthStencilState;
+		depthStencilStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilStateCreateInfo.pNext = nullptr;
+		depthStencilStateCreateInfo.flags = 0;
+		depthStencilStateCreateInfo.depthTestEnable = description.depthTestEnable ? VK_TRUE : VK_FALSE;
+		depthStencilStateCreateInfo.depthWriteEnable = description.depthWriteEnable ? VK_TRUE : VK_FALSE;
+		depthStencilStateCreateInfo.depthCompareOp = description.depthCompareOp;
+		depthStencilStateCreateInfo.depthBoundsTestEnable = VK_FALSE;
+		depthStencilStateCreateInfo.stencilTestEnable = VK_FALSE;
+		depthStencilStateCreateInfo.front = {};
+		depthStencilStateCreateInfo.back = {};
+		depthStencilStateCreateInfo.minDepthBounds = 0;
+		depthStencilStateCreateInfo.maxDepthBounds = 0;
+		graphicsPipelineCreateInfo.pDepthStencilState = &depthStencilStateCreateInfo;
+	}
+
+}
+
+namespace vkfw
+{
+	bool PipelineHandle::isReady() const
+	{
+		if (m_pipeline != VK_NULL_HANDLE)
+		{
+			return true;
+		}
+		if (!m_compiledPipeline.valid() || m_compiledPipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return false;
+		}
+		m_pipeline = m_compiledPipeline.get().pipeline;
+		return true;
+	}
+
+	VkPipeline PipelineHandle::get() const
+	{
+		return isReady() ? m_pipeline : m_fallback;
+	}
+
+	VkPipeline PipelineHandle::wait() const
+	{
+		if (!m_compiledPipeline.valid())
+		{
+			return m_fallback;
+		}
+		m_pipeline = m_compiledPipeline.get().pipeline;
+		return m_pipeline;
+	}
+
+	PipelineCache::PipelineCache(VkDevice device, const VkAllocationCallbacks *allocCb, ThreadPool &threadPool) : m_device(device),
+																												  m_allocCb(allocCb),
+																												  m_threadPool(threadPool)
+	{
+		VkPipelineCacheCreateInfo pipelineCacheCreateInfo;
+		pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		pipelineCacheCreateInfo.pNext = nullptr;
+		pipelineCacheCreateInfo.flags = 0;
+		pipelineCacheCreateInfo.initialDataSize = 0;
+		pipelineCacheCreateInfo.pInitialData = nullptr;
+
+		vkfwCheckVkResult(vkCreatePipelineCache(m_device, &pipelineCacheCreateInfo, m_allocCb, &m_handle));
+	}
+
+	PipelineCache::~PipelineCache()
+	{
+		clear();
+		vkDestroyPipelineCache(m_device, m_handle, m_allocCb);
+	}
+
+	void PipelineCache::request(const GraphicsPipelineDescription &description)
+	{
+		if (m_pipelines.find(description) != m_pipelines.end())
+		{
+			return;
+		}
+		auto promise = std::make_shared<std::promise<CompiledPipeline>>();
+		m_pipelines.emplace(description, promise->get_future().share());
+		m_pendingPipelines.emplace_back(PendingPipeline{description, promise});
+	}
+
+	void PipelineCache::flush()
+	{
+		if (m_pendingPipelines.empty())
+		{
+			return;
+		}
+
+		std::vector<GraphicsPipelineCreateInfoStorage> storages(m_pendingPipelines.size());
+		std::vector<VkGraphicsPipelineCreateInfo> graphicsPipelineCreateInfos(m_pendingPipelines.size());
+		for (size_t i = 0; i < m_pendingPipelines.size(); ++i)
+		{
+			initGraphicsPipelineCreateInfo(m_pendingPipelines[i].description, storages[i], graphicsPipelineCreateInfos[i]);
+		}
+
+		std::vector<VkPipeline> pipelines(m_pendingPipelines.size());
+
+		auto start = std::chrono::steady_clock::now();
+		vkfwCheckVkResult(vkCreateGraphicsPipelines(m_device, m_handle, (uint32_t)graphicsPipelineCreateInfos.size(), &graphicsPipelineCreateInfos[0], m_allocCb, &pipelines[0]));
+		auto creationTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		for (size_t i = 0; i < m_pendingPipelines.size(); ++i)
+		{
+			m_pendingPipelines[i].promise->set_value(CompiledPipeline{pipelines[i], creationTime / m_pendingPipelines.size()});
+		}
+		m_pendingPipelines.clear();
+	}
+
+	VkPipeline PipelineCache::get(const GraphicsPipelineDescription &description)
+	{
+		request(description);
+		flush();
+		// blocks if the pipeline is being compiled asynchronously
+		return m_pipelines[description].get().pipeline;
+	}
+
+	PipelineHandle PipelineCache::requestAsync(const GraphicsPipelineDescription &description, VkPipeline fallback)
+	{
+		auto it = m_pipelines.find(description);
+		if (it == m_pipelines.end())
+		{
+			auto device = m_device;
+			auto allocCb = m_allocCb;
+			auto pipelineCache = m_handle;
+			// each worker creates a single pipeline, so there's no batch cost to split
+			auto compiledPipeline = m_threadPool.enqueue([device, allocCb, pipelineCache, description]()
+														 {
+				GraphicsPipelineCreateInfoStorage storage;
+				VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo;
+				initGraphicsPipelineCreateInfo(description, storage, graphicsPipelineCreateInfo);
+
+				CompiledPipeline compiledPipeline;
+				auto start = std::chrono::steady_clock::now();
+				vkfwCheckVkResult(vkCreateGraphicsPipelines(device, pipelineCache, 1, &graphicsPipelineCreateInfo, allocCb, &compiledPipeline.pipeline));
+				compiledPipeline.creationTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				return compiledPipeline; });
+			it = m_pipelines.emplace(description, compiledPipeline.share()).first;
+		}
+		return PipelineHandle(it->second, fallback);
+	}
+
+	double PipelineCache::getCreationTime(const GraphicsPipelineDescription &description) const
+	{
+		auto it = m_pipelines.find(description);
+		if (it == m_pipelines.end() || it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return 0;
+		}
+		return it->second.get().creationTime;
+	}
+
+	// pipelines still compiling don't count
+	double PipelineCache::getTotalCreationTime() const
+	{
+		double totalCreationTime = 0;
+		for (const auto &entry : m_pipelines)
+		{
+			if (entry.second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			{
+				totalCreationTime += entry.second.get().creationTime;
+			}
+		}
+		return totalCreationTime;
+	}
+
+	template <typename PredicateType>
+	void PipelineCache::evictIf(PredicateType predicate)
+	{
+		// so that every entry is backed by a real pipeline (or one being compiled by a worker, which we wait for)
+		flush();
+		for (auto it = m_pipelines.begin(); it != m_pipelines.end();)
+		{
+			if (predicate(it->first))
+			{
+				vkDestroyPipeline(m_device, it->second.get().pipeline, m_allocCb);
+				it = m_pipelines.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+
+	void PipelineCache::evictShaderModule(VkShaderModule shaderModule)
+	{
+		evictIf([shaderModule](const GraphicsPipelineDescription &description)
+				{ return description.vertexShader == shaderModule || description.fragmentShader == shaderModule; });
+	}
+
+	void PipelineCache::evictPipelineLayout(VkPipelineLayout pipelineLayout)
+	{
+		evictIf([pipelineLayout](const GraphicsPipelineDescription &description)
+				{ return description.layout == pipelineLayout; });
+	}
+
+	void PipelineCache::clear()
+	{
+		evictIf([](const GraphicsPipelineDescription &)
+				{ return true; });
+	}
+
+}
@@ -0,0 +1,31 @@
+#include <vkfw/PushConstants.h>
+
+namespace vkfw
+{
+	Result validatePushConstantRanges(const VkPhysicalDeviceLimits &limits, const VkPushConstantRange *pushConstantRanges, uint32_t pushConstantRangeCount)
+	{
+		VkShaderStageFlags usedStages = 0;
+		for (uint32_t i = 0; i < pushConstantRangeCount; ++i)
+		{
+			const auto &pushConstantRange = pushConstantRanges[i];
+			if (pushConstantRange.size == 0)
+			{
+				return "push constant range is empty";
+			}
+			if ((pushConstantRange.offset % 4) != 0 || (pushConstantRange.size % 4) != 0)
+			{
+				return "push constant range offset and size must be multiples of 4";
+			}
+			if (pushConstantRange.offset + pushConstantRange.size > limits.maxPushConstantsSize)
+			{
+				return "push constant range exceeds maxPushConstantsSize";
+			}
+			if ((usedStages & pushConstantRange.stageFlags) != 0)
+			{
+				return "more than one push constant range declared for the same shader stage";
+			}
+			usedStages |= pushConstantRange.stageFlags;
+		}
+		return {};
+	}
+}
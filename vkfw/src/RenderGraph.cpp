@@ -0,0 +1,755 @@
+#include <vkfw/Hash.h>
+#include <vkfw/RenderGraph.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	constexpr VkAccessFlags gc_writeAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	struct UsageInfo
+	{
+		VkPipelineStageFlags stageMask;
+		VkAccessFlags readAccessMask;
+		VkAccessFlags writeAccessMask;
+		VkImageLayout layout;
+		VkImageUsageFlags imageUsage;
+		VkBufferUsageFlags bufferUsage;
+	};
+
+	UsageInfo getUsageInfo(vkfw::ResourceUsage usage)
+	{
+		switch (usage)
+		{
+		case vkfw::ResourceUsage::Undefined:
+			return {0, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, 0};
+		case vkfw::ResourceUsage::SwapChainAcquire:
+			// must match the wait stage of the image acquisition semaphore, so that the first layout transition chains with it
+			return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, 0};
+		case vkfw::ResourceUsage::ColorAttachment:
+			return {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, 0};
+		case vkfw::ResourceUsage::DepthStencilAttachment:
+			return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+		case vkfw::ResourceUsage::DepthStencilReadOnly:
+			return {VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, 0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, 0};
+		case vkfw::ResourceUsage::SampledByFragmentShader:
+			return {VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT};
+		case vkfw::ResourceUsage::SampledByComputeShader:
+			return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, 0, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_USAGE_SAMPLED_BIT, VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT};
+		case vkfw::ResourceUsage::StorageByVertexShader:
+			return {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT};
+		case vkfw::ResourceUsage::StorageByComputeShader:
+			return {VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_USAGE_STORAGE_BIT, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT};
+		case vkfw::ResourceUsage::UniformBuffer:
+			return {VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT};
+		case vkfw::ResourceUsage::VertexBuffer:
+			return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT};
+		case vkfw::ResourceUsage::IndexBuffer:
+			return {VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDEX_BUFFER_BIT};
+		case vkfw::ResourceUsage::IndirectBuffer:
+			return {VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT};
+		case vkfw::ResourceUsage::TransferSource:
+			return {VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, 0, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT};
+		case vkfw::ResourceUsage::TransferDestination:
+			return {VK_PIPELINE_STAGE_TRANSFER_BIT, 0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_BUFFER_USAGE_TRANSFER_DST_BIT};
+		case vkfw::ResourceUsage::Present:
+			return {VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, 0, 0};
+		default:
+			assert(false);
+			return {0, 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, 0, 0};
+		}
+	}
+
+}
+
+namespace vkfw
+{
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::read(const std::string &name, ResourceUsage usage)
+	{
+		m_renderGraph.addAccess(m_passIndex, name, usage, false);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::write(const std::string &name, ResourceUsage usage)
+	{
+		m_renderGraph.addAccess(m_passIndex, name, usage, true);
+		return *this;
+	}
+
+	RenderGraph::PassBuilder &RenderGraph::PassBuilder::setSideEffects()
+	{
+		m_renderGraph.m_passes[m_passIndex].sideEffects = true;
+		return *this;
+	}
+
+	RenderGraph::RenderGraph(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, uint32_t frameCount) : m_device(device),
+																																				m_allocCb(allocCb),
+																																				m_findMemoryTypeCb(std::move(findMemoryTypeCb)),
+																																				m_frameResources(frameCount)
+	{
+	}
+
+	RenderGraph::~RenderGraph()
+	{
+		for (auto &frameResources : m_frameResources)
+		{
+			destroyFrameResources(frameResources);
+		}
+	}
+
+	void RenderGraph::reset()
+	{
+		m_passes.clear();
+		m_resources.clear();
+		m_resourceIndices.clear();
+		m_aliasSlotCount = 0;
+		m_finalBarrier = {};
+		m_compiled = false;
+		m_culledPassCount = 0;
+		m_barrierCount = 0;
+	}
+
+	uint32_t RenderGraph::addResource(const std::string &name)
+	{
+		if (m_resourceIndices.find(name) != m_resourceIndices.end())
+		{
+			fail("render graph resource %s declared twice", name.c_str());
+		}
+		auto resourceIndex = (uint32_t)m_resources.size();
+		m_resources.emplace_back();
+		m_resources.back().name = name;
+		m_resourceIndices[name] = resourceIndex;
+		m_compiled = false;
+		return resourceIndex;
+	}
+
+	uint32_t RenderGraph::findResource(const std::string &name) const
+	{
+		auto it = m_resourceIndices.find(name);
+		if (it == m_resourceIndices.end())
+		{
+			fail("unknown render graph resource %s", name.c_str());
+		}
+		return it->second;
+	}
+
+	void RenderGraph::importImage(const std::string &name, VkImage image, VkImageView imageView, VkImageAspectFlags aspectMask, ResourceUsage initialUsage, ResourceUsage finalUsage)
+	{
+		auto &resource = m_resources[addResource(name)];
+		resource.image = true;
+		resource.imported = true;
+		resource.importedImage = image;
+		resource.importedImageView = imageView;
+		resource.aspectMask = aspectMask;
+		resource.initialUsage = initialUsage;
+		resource.finalUsage = finalUsage;
+	}
+
+	void RenderGraph::importBuffer(const std::string &name, VkBuffer buffer, ResourceUsage initialUsage, ResourceUsage finalUsage)
+	{
+		auto &resource = m_resources[addResource(name)];
+		resource.imported = true;
+		resource.importedBuffer = buffer;
+		resource.initialUsage = initialUsage;
+		resource.finalUsage = finalUsage;
+	}
+
+	void RenderGraph::createImage(const std::string &name, const RenderGraphImageDescription &description)
+	{
+		auto &resource = m_resources[addResource(name)];
+		resource.image = true;
+		resource.imageDescription = description;
+		resource.aspectMask = description.aspectMask;
+	}
+
+	void RenderGraph::createBuffer(const std::string &name, const RenderGraphBufferDescription &description)
+	{
+		auto &resource = m_resources[addResource(name)];
+		resource.bufferDescription = description;
+	}
+
+	RenderGraph::PassBuilder RenderGraph::addPass(const std::string &name, RecordCallback recordCallback)
+	{
+		auto passIndex = (uint32_t)m_passes.size();
+		m_passes.emplace_back();
+		m_passes.back().name = name;
+		m_passes.back().recordCallback = std::move(recordCallback);
+		m_compiled = false;
+		return PassBuilder(*this, passIndex);
+	}
+
+	void RenderGraph::addAccess(uint32_t passIndex, const std::string &name, ResourceUsage usage, bool write)
+	{
+		auto resourceIndex = findResource(name);
+		auto &resource = m_resources[resourceIndex];
+		auto usageInfo = getUsageInfo(usage);
+
+		if (write && usageInfo.writeAccessMask == 0)
+		{
+			fail("resource %s cannot be written as declared", name.c_str());
+		}
+		if (!write && usageInfo.readAccessMask == 0)
+		{
+			fail("resource %s cannot be read as declared", name.c_str());
+		}
+
+		if (resource.image)
+		{
+			resource.imageDescription.usage |= usageInfo.imageUsage;
+		}
+		else
+		{
+			resource.bufferDescription.usage |= usageInfo.bufferUsage;
+		}
+
+		// a write needs visibility of everything the pass may access in that usage (ie, depth tests or blending read what's being written)
+		auto accessMask = write ? (usageInfo.readAccessMask | usageInfo.writeAccessMask) : usageInfo.readAccessMask;
+
+		auto &accesses = m_passes[passIndex].accesses;
+		auto it = std::find_if(accesses.begin(), accesses.end(), [resourceIndex](const auto &access)
+							   { return access.resourceIndex == resourceIndex; });
+		if (it != accesses.end())
+		{
+			if (resource.image && it->layout != usageInfo.layout)
+			{
+				fail("resource %s is used with conflicting layouts in pass %s", name.c_str(), m_passes[passIndex].name.c_str());
+			}
+			it->stageMask |= usageInfo.stageMask;
+			it->accessMask |= accessMask;
+			it->read |= !write;
+			it->write |= write;
+		}
+		else
+		{
+			accesses.emplace_back(Access{resourceIndex, usageInfo.stageMask, accessMask, usageInfo.layout, !write, write});
+		}
+		m_compiled = false;
+	}
+
+	void RenderGraph::compile()
+	{
+		cullPasses();
+		assignAliasSlots();
+		planBarriers();
+		m_compiled = true;
+	}
+
+	void RenderGraph::cullPasses()
+	{
+		// walk the passes backwards, starting from the resources that outlive the graph,
+		// and keep only the passes that contribute to them (or that were explicitly flagged as having side effects)
+		std::vector<bool> neededResources(m_resources.size(), false);
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			neededResources[i] = m_resources[i].imported && m_resources[i].finalUsage != ResourceUsage::Undefined;
+		}
+
+		m_culledPassCount = 0;
+		for (auto passIt = m_passes.rbegin(); passIt != m_passes.rend(); ++passIt)
+		{
+			auto &pass = *passIt;
+			pass.culled = !pass.sideEffects && std::none_of(pass.accesses.begin(), pass.accesses.end(), [&neededResources](const auto &access)
+															{ return access.write && neededResources[access.resourceIndex]; });
+			if (pass.culled)
+			{
+				m_culledPassCount++;
+				continue;
+			}
+			// overwriting a resource without reading it makes previous producers irrelevant
+			for (const auto &access : pass.accesses)
+			{
+				if (access.write && !access.read)
+				{
+					neededResources[access.resourceIndex] = false;
+				}
+			}
+			for (const auto &access : pass.accesses)
+			{
+				if (access.read)
+				{
+					neededResources[access.resourceIndex] = true;
+				}
+			}
+		}
+
+		for (auto &resource : m_resources)
+		{
+			resource.firstPass = ~0u;
+			resource.lastPass = 0;
+		}
+		for (uint32_t passIndex = 0; passIndex < (uint32_t)m_passes.size(); ++passIndex)
+		{
+			if (m_passes[passIndex].culled)
+			{
+				continue;
+			}
+			for (const auto &access : m_passes[passIndex].accesses)
+			{
+				auto &resource = m_resources[access.resourceIndex];
+				resource.firstPass = std::min(resource.firstPass, passIndex);
+				resource.lastPass = std::max(resource.lastPass, passIndex);
+			}
+		}
+	}
+
+	void RenderGraph::assignAliasSlots()
+	{
+		// interval partitioning: transient resources of the same kind whose lifetimes don't overlap share a memory slot
+		std::vector<uint32_t> transientResources;
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			m_resources[i].aliasSlot = sc_noAliasSlot;
+			if (!m_resources[i].imported && m_resources[i].firstPass != ~0u)
+			{
+				transientResources.emplace_back(i);
+			}
+		}
+		std::stable_sort(transientResources.begin(), transientResources.end(), [this](uint32_t a, uint32_t b)
+						 { return m_resources[a].firstPass < m_resources[b].firstPass; });
+
+		struct AliasSlot
+		{
+			bool image;
+			uint32_t lastPass;
+		};
+		std::vector<AliasSlot> aliasSlots;
+		for (auto resourceIndex : transientResources)
+		{
+			auto &resource = m_resources[resourceIndex];
+			auto it = std::find_if(aliasSlots.begin(), aliasSlots.end(), [&resource](const auto &aliasSlot)
+								   { return aliasSlot.image == resource.image && aliasSlot.lastPass < resource.firstPass; });
+			if (it == aliasSlots.end())
+			{
+				aliasSlots.emplace_back(AliasSlot{resource.image, resource.lastPass});
+				resource.aliasSlot = (uint32_t)aliasSlots.size() - 1;
+			}
+			else
+			{
+				it->lastPass = resource.lastPass;
+				resource.aliasSlot = (uint32_t)(it - aliasSlots.begin());
+			}
+		}
+		m_aliasSlotCount = (uint32_t)aliasSlots.size();
+	}
+
+	void RenderGraph::transition(uint32_t resourceIndex, const Access &access, ResourceState &state, Barrier &barrier)
+	{
+		const auto &resource = m_resources[resourceIndex];
+		bool layoutTransition = resource.image && state.layout != access.layout;
+		auto previousStageMask = state.writeStageMask | state.readStageMask;
+
+		if (layoutTransition || access.write)
+		{
+			// layout transitions and writes have to wait for every previous access (RAW, WAR and WAW hazards)
+			if (layoutTransition || previousStageMask != 0)
+			{
+				barrier.srcStageMask |= previousStageMask;
+				barrier.dstStageMask |= access.stageMask;
+				if (layoutTransition)
+				{
+					// discarding the previous contents lets the driver skip preserving them
+					auto oldLayout = (access.write && !access.read) ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+					barrier.imageBarriers.emplace_back(ImageBarrier{resourceIndex, state.writeAccessMask, access.accessMask, oldLayout, access.layout});
+				}
+				else
+				{
+					barrier.srcBufferAccessMask |= state.writeAccessMask;
+					barrier.dstBufferAccessMask |= access.accessMask;
+					barrier.hasBufferBarrier = true;
+				}
+			}
+			state.layout = access.layout;
+			// a layout transition behaves as a write performed on behalf of the accessing stages
+			state.writeStageMask = access.stageMask;
+			state.writeAccessMask = access.accessMask & gc_writeAccessMask;
+			state.readStageMask = access.write ? 0 : access.stageMask;
+			state.visibleStageMask = access.stageMask;
+			state.visibleAccessMask = access.accessMask;
+		}
+		else
+		{
+			// read-after-read needs nothing, read-after-write only if the pending writes haven't been made visible to this access yet
+			if (state.writeStageMask != 0 && ((access.stageMask & ~state.visibleStageMask) != 0 || (access.accessMask & ~state.visibleAccessMask) != 0))
+			{
+				barrier.srcStageMask |= state.writeStageMask;
+				barrier.dstStageMask |= access.stageMask;
+				barrier.srcBufferAccessMask |= state.writeAccessMask;
+				barrier.dstBufferAccessMask |= access.accessMask;
+				barrier.hasBufferBarrier = true;
+				state.visibleStageMask |= access.stageMask;
+				state.visibleAccessMask |= access.accessMask;
+			}
+			state.readStageMask |= access.stageMask;
+		}
+	}
+
+	void RenderGraph::planBarriers()
+	{
+		std::vector<ResourceState> states(m_resources.size());
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			const auto &resource = m_resources[i];
+			if (!resource.imported)
+			{
+				continue;
+			}
+			auto usageInfo = getUsageInfo(resource.initialUsage);
+			auto &state = states[i];
+			state.layout = usageInfo.layout;
+			if (usageInfo.writeAccessMask != 0)
+			{
+				state.writeStageMask = usageInfo.stageMask;
+				state.writeAccessMask = usageInfo.writeAccessMask;
+			}
+			else
+			{
+				state.readStageMask = usageInfo.stageMask;
+			}
+		}
+
+		std::vector<uint32_t> aliasSlotOccupants(m_aliasSlotCount, ~0u);
+
+		m_barrierCount = 0;
+		for (uint32_t passIndex = 0; passIndex < (uint32_t)m_passes.size(); ++passIndex)
+		{
+			auto &pass = m_passes[passIndex];
+			pass.barrier = {};
+			if (pass.culled)
+			{
+				continue;
+			}
+			for (const auto &access : pass.accesses)
+			{
+				const auto &resource = m_resources[access.resourceIndex];
+				auto &state = states[access.resourceIndex];
+				if (resource.aliasSlot != sc_noAliasSlot && resource.firstPass == passIndex)
+				{
+					// the memory slot may still be in use by its previous occupant
+					auto &occupant = aliasSlotOccupants[resource.aliasSlot];
+					if (occupant != ~0u)
+					{
+						const auto &occupantState = states[occupant];
+						state.writeStageMask = occupantState.writeStageMask | occupantState.readStageMask;
+						state.writeAccessMask = occupantState.writeAccessMask;
+					}
+					occupant = access.resourceIndex;
+				}
+				transition(access.resourceIndex, access, state, pass.barrier);
+			}
+			if (pass.barrier.srcStageMask != 0 || pass.barrier.dstStageMask != 0)
+			{
+				m_barrierCount++;
+			}
+		}
+
+		m_finalBarrier = {};
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			const auto &resource = m_resources[i];
+			if (!resource.imported || resource.finalUsage == ResourceUsage::Undefined)
+			{
+				continue;
+			}
+			auto usageInfo = getUsageInfo(resource.finalUsage);
+			Access finalAccess{i, usageInfo.stageMask, usageInfo.readAccessMask, usageInfo.layout, true, false};
+			transition(i, finalAccess, states[i], m_finalBarrier);
+		}
+		if (m_finalBarrier.srcStageMask != 0 || m_finalBarrier.dstStageMask != 0)
+		{
+			m_barrierCount++;
+		}
+	}
+
+	size_t RenderGraph::computeTransientSignature() const
+	{
+		size_t signature = m_aliasSlotCount;
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			const auto &resource = m_resources[i];
+			if (resource.imported || resource.aliasSlot == sc_noAliasSlot)
+			{
+				continue;
+			}
+			hashCombine(signature, i, resource.image, resource.aliasSlot);
+			if (resource.image)
+			{
+				const auto &description = resource.imageDescription;
+				hashCombine(signature, (uint32_t)description.format, description.width, description.height, description.aspectMask, description.usage);
+			}
+			else
+			{
+				const auto &description = resource.bufferDescription;
+				hashCombine(signature, description.size, description.usage);
+			}
+		}
+		return signature;
+	}
+
+	void RenderGraph::allocateTransientResources(uint32_t frameIndex)
+	{
+		auto &frameResources = m_frameResources[frameIndex];
+		auto signature = computeTransientSignature();
+		if (frameResources.signature == signature && frameResources.images.size() == m_resources.size())
+		{
+			return;
+		}
+
+		// the caller guarantees the frame isn't in flight anymore
+		destroyFrameResources(frameResources);
+
+		frameResources.images.assign(m_resources.size(), VK_NULL_HANDLE);
+		frameResources.imageViews.assign(m_resources.size(), VK_NULL_HANDLE);
+		frameResources.buffers.assign(m_resources.size(), VK_NULL_HANDLE);
+
+		std::vector<VkMemoryRequirements> resourceMemoryRequirements(m_resources.size());
+		std::vector<VkMemoryRequirements> aliasSlotMemoryRequirements(m_aliasSlotCount, VkMemoryRequirements{0, 1, ~0u});
+		std::vector<bool> dedicatedMemory(m_resources.size(), false);
+
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			const auto &resource = m_resources[i];
+			if (resource.imported || resource.aliasSlot == sc_noAliasSlot)
+			{
+				continue;
+			}
+
+			auto &memoryRequirements = resourceMemoryRequirements[i];
+			if (resource.image)
+			{
+				VkImageCreateInfo imageCreateInfo;
+				imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+				imageCreateInfo.pNext = nullptr;
+				imageCreateInfo.flags = 0;
+				imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+				imageCreateInfo.format = resource.imageDescription.format;
+				imageCreateInfo.extent = {resource.imageDescription.width, resource.imageDescription.height, 1};
+				imageCreateInfo.mipLevels = 1;
+				imageCreateInfo.arrayLayers = 1;
+				imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+				imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+				imageCreateInfo.usage = resource.imageDescription.usage;
+				imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+				imageCreateInfo.queueFamilyIndexCount = 0;
+				imageCreateInfo.pQueueFamilyIndices = nullptr;
+				imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+				vkfwCheckVkResult(vkCreateImage(m_device, &imageCreateInfo, m_allocCb, &frameResources.images[i]));
+				vkGetImageMemoryRequirements(m_device, frameResources.images[i], &memoryRequirements);
+			}
+			else
+			{
+				VkBufferCreateInfo bufferCreateInfo;
+				bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+				bufferCreateInfo.pNext = nullptr;
+				bufferCreateInfo.flags = 0;
+				bufferCreateInfo.size = resource.bufferDescription.size;
+				bufferCreateInfo.usage = resource.bufferDescription.usage;
+				bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+				bufferCreateInfo.queueFamilyIndexCount = 0;
+				bufferCreateInfo.pQueueFamilyIndices = nullptr;
+				vkfwCheckVkResult(vkCreateBuffer(m_device, &bufferCreateInfo, m_allocCb, &frameResources.buffers[i]));
+				vkGetBufferMemoryRequirements(m_device, frameResources.buffers[i], &memoryRequirements);
+			}
+
+			auto &slotMemoryRequirements = aliasSlotMemoryRequirements[resource.aliasSlot];
+			if ((slotMemoryRequirements.memoryTypeBits & memoryRequirements.memoryTypeBits) == 0)
+			{
+				// can't share a memory type with the other occupants of the slot
+				dedicatedMemory[i] = true;
+				continue;
+			}
+			slotMemoryRequirements.size = std::max(slotMemoryRequirements.size, memoryRequirements.size);
+			slotMemoryRequirements.alignment = std::max(slotMemoryRequirements.alignment, memoryRequirements.alignment);
+			slotMemoryRequirements.memoryTypeBits &= memoryRequirements.memoryTypeBits;
+		}
+
+		auto allocateMemory = [this](const VkMemoryRequirements &memoryRequirements)
+		{
+			VkMemoryAllocateInfo memoryAllocateInfo;
+			memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			memoryAllocateInfo.pNext = nullptr;
+			memoryAllocateInfo.allocationSize = memoryRequirements.size;
+			memoryAllocateInfo.memoryTypeIndex = m_findMemoryTypeCb(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			VkDeviceMemory memory;
+			vkfwCheckVkResult(vkAllocateMemory(m_device, &memoryAllocateInfo, m_allocCb, &memory));
+			return memory;
+		};
+
+		std::vector<VkDeviceMemory> aliasSlotMemories(m_aliasSlotCount, VK_NULL_HANDLE);
+		for (uint32_t i = 0; i < m_aliasSlotCount; ++i)
+		{
+			if (aliasSlotMemoryRequirements[i].size > 0)
+			{
+				aliasSlotMemories[i] = allocateMemory(aliasSlotMemoryRequirements[i]);
+				frameResources.memories.emplace_back(aliasSlotMemories[i]);
+			}
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_resources.size(); ++i)
+		{
+			const auto &resource = m_resources[i];
+			if (resource.imported || resource.aliasSlot == sc_noAliasSlot)
+			{
+				continue;
+			}
+
+			VkDeviceMemory memory;
+			if (dedicatedMemory[i])
+			{
+				memory = allocateMemory(resourceMemoryRequirements[i]);
+				frameResources.memories.emplace_back(memory);
+			}
+			else
+			{
+				memory = aliasSlotMemories[resource.aliasSlot];
+			}
+
+			if (resource.image)
+			{
+				vkfwCheckVkResult(vkBindImageMemory(m_device, frameResources.images[i], memory, 0));
+
+				VkImageViewCreateInfo imageViewCreateInfo;
+				imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+				imageViewCreateInfo.pNext = nullptr;
+				imageViewCreateInfo.flags = 0;
+				imageViewCreateInfo.image = frameResources.images[i];
+				imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+				imageViewCreateInfo.format = resource.imageDescription.format;
+				imageViewCreateInfo.components = {VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
+				imageViewCreateInfo.subresourceRange = {resource.aspectMask, 0, 1, 0, 1};
+				vkfwCheckVkResult(vkCreateImageView(m_device, &imageViewCreateInfo, m_allocCb, &frameResources.imageViews[i]));
+			}
+			else
+			{
+				vkfwCheckVkResult(vkBindBufferMemory(m_device, frameResources.buffers[i], memory, 0));
+			}
+		}
+
+		frameResources.signature = signature;
+	}
+
+	void RenderGraph::destroyFrameResources(FrameResources &frameResources)
+	{
+		for (auto imageView : frameResources.imageViews)
+		{
+			if (imageView != VK_NULL_HANDLE)
+			{
+				vkDestroyImageView(m_device, imageView, m_allocCb);
+			}
+		}
+		for (auto image : frameResources.images)
+		{
+			if (image != VK_NULL_HANDLE)
+			{
+				vkDestroyImage(m_device, image, m_allocCb);
+			}
+		}
+		for (auto buffer : frameResources.buffers)
+		{
+			if (buffer != VK_NULL_HANDLE)
+			{
+				vkDestroyBuffer(m_device, buffer, m_allocCb);
+			}
+		}
+		for (auto memory : frameResources.memories)
+		{
+			vkFreeMemory(m_device, memory, m_allocCb);
+		}
+		frameResources = {};
+	}
+
+	void RenderGraph::execute(VkCommandBuffer commandBuffer, uint32_t frameIndex)
+	{
+		if (!m_compiled)
+		{
+			fail("render graph has to be compiled before being executed");
+		}
+		if (frameIndex >= (uint32_t)m_frameResources.size())
+		{
+			fail("invalid render graph frame index %d", frameIndex);
+		}
+
+		m_frameIndex = frameIndex;
+		allocateTransientResources(frameIndex);
+
+		for (const auto &pass : m_passes)
+		{
+			if (pass.culled)
+			{
+				continue;
+			}
+			recordBarrier(commandBuffer, pass.barrier);
+			if (pass.recordCallback)
+			{
+				pass.recordCallback(commandBuffer, *this);
+			}
+		}
+
+		recordBarrier(commandBuffer, m_finalBarrier);
+	}
+
+	void RenderGraph::recordBarrier(VkCommandBuffer commandBuffer, const Barrier &barrier) const
+	{
+		if (!barrier.hasBufferBarrier && barrier.imageBarriers.empty())
+		{
+			return;
+		}
+
+		VkMemoryBarrier memoryBarrier;
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.pNext = nullptr;
+		memoryBarrier.srcAccessMask = barrier.srcBufferAccessMask;
+		memoryBarrier.dstAccessMask = barrier.dstBufferAccessMask;
+
+		std::vector<VkImageMemoryBarrier> imageMemoryBarriers(barrier.imageBarriers.size());
+		for (size_t i = 0; i < barrier.imageBarriers.size(); ++i)
+		{
+			const auto &imageBarrier = barrier.imageBarriers[i];
+			const auto &resource = m_resources[imageBarrier.resourceIndex];
+			auto &imageMemoryBarrier = imageMemoryBarriers[i];
+			imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imageMemoryBarrier.pNext = nullptr;
+			imageMemoryBarrier.srcAccessMask = imageBarrier.srcAccessMask;
+			imageMemoryBarrier.dstAccessMask = imageBarrier.dstAccessMask;
+			imageMemoryBarrier.oldLayout = imageBarrier.oldLayout;
+			imageMemoryBarrier.newLayout = imageBarrier.newLayout;
+			imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageMemoryBarrier.image = resource.imported ? resource.importedImage : m_frameResources[m_frameIndex].images[imageBarrier.resourceIndex];
+			imageMemoryBarrier.subresourceRange = {resource.aspectMask, 0, 1, 0, 1};
+		}
+
+		vkCmdPipelineBarrier(commandBuffer,
+							 barrier.srcStageMask != 0 ? barrier.srcStageMask : (VkPipelineStageFlags)VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+							 barrier.dstStageMask != 0 ? barrier.dstStageMask : (VkPipelineStageFlags)VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+							 0,
+							 barrier.hasBufferBarrier ? 1 : 0,
+							 barrier.hasBufferBarrier ? &memoryBarrier : nullptr,
+							 0,
+							 nullptr,
+							 (uint32_t)imageMemoryBarriers.size(),
+							 imageMemoryBarriers.empty() ? nullptr : &imageMemoryBarriers[0]);
+	}
+
+	VkImage RenderGraph::getImage(const std::string &name) const
+	{
+		auto resourceIndex = findResource(name);
+		const auto &resource = m_resources[resourceIndex];
+		return resource.imported ? resource.importedImage : m_frameResources[m_frameIndex].images[resourceIndex];
+	}
+
+	VkImageView RenderGraph::getImageView(const std::string &name) const
+	{
+		auto resourceIndex = findResource(name);
+		const auto &resource = m_resources[resourceIndex];
+		return resource.imported ? resource.importedImageView : m_frameResources[m_frameIndex].imageViews[resourceIndex];
+	}
+
+	VkBuffer RenderGraph::getBuffer(const std::string &name) const
+	{
+		auto resourceIndex = findResource(name);
+		const auto &resource = m_resources[resourceIndex];
+		return resource.imported ? resource.importedBuffer : m_frameResources[m_frameIndex].buffers[resourceIndex];
+	}
+
+}
@@ -0,0 +1,155 @@
+#include <vkfw/Hash.h>
+#include <vkfw/RenderPassCache.h>
+
+namespace
+{
+	VkAttachmentDescription getAttachmentDescription(const vkfw::RenderPassAttachment &attachment)
+	{
+		VkAttachmentDescription attachmentDescription;
+		attachmentDescription.flags = 0;
+		attachmentDescription.format = attachment.format;
+		attachmentDescription.samples = attachment.samples;
+		attachmentDescription.loadOp = attachment.loadOp;
+		attachmentDescription.storeOp = attachment.storeOp;
+		attachmentDescription.stencilLoadOp = attachment.stencilLoadOp;
+		attachmentDescription.stencilStoreOp = attachment.stencilStoreOp;
+		attachmentDescription.initialLayout = attachment.initialLayout;
+		attachmentDescription.finalLayout = attachment.finalLayout;
+		return attachmentDescription;
+	}
+
+}
+
+namespace vkfw
+{
+	bool RenderPassAttachment::operator==(const RenderPassAttachment &other) const
+	{
+		return format == other.format &&
+			   samples == other.samples &&
+			   loadOp == other.loadOp &&
+			   storeOp == other.storeOp &&
+			   stencilLoadOp == other.stencilLoadOp &&
+			   stencilStoreOp == other.stencilStoreOp &&
+			   initialLayout == other.initialLayout &&
+			   finalLayout == other.finalLayout;
+	}
+
+	size_t RenderPassAttachment::getHash() const
+	{
+		size_t hash = 0;
+		hashCombine(hash, format, samples, loadOp, storeOp, stencilLoadOp, stencilStoreOp, initialLayout, finalLayout);
+		return hash;
+	}
+
+	bool RenderPassDescription::operator==(const RenderPassDescription &other) const
+	{
+		if (colorAttachmentCount != other.colorAttachmentCount || hasDepthStencilAttachment != other.hasDepthStencilAttachment)
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < colorAttachmentCount; ++i)
+		{
+			if (!(colorAttachments[i] == other.colorAttachments[i]))
+			{
+				return false;
+			}
+		}
+		return !hasDepthStencilAttachment || depthStencilAttachment == other.depthStencilAttachment;
+	}
+
+	size_t RenderPassDescription::getHash() const
+	{
+		size_t hash = 0;
+		hashCombine(hash, colorAttachmentCount, hasDepthStencilAttachment);
+		for (uint32_t i = 0; i < colorAttachmentCount; ++i)
+		{
+			hashCombine(hash, colorAttachments[i].getHash());
+		}
+		if (hasDepthStencilAttachment)
+		{
+			hashCombine(hash, depthStencilAttachment.getHash());
+		}
+		return hash;
+	}
+
+	RenderPassCache::RenderPassCache(VkDevice device, const VkAllocationCallbacks *allocCb) : m_device(device),
+																							  m_allocCb(allocCb)
+	{
+	}
+
+	RenderPassCache::~RenderPassCache()
+	{
+		clear();
+	}
+
+	VkRenderPass RenderPassCache::get(const RenderPassDescription &description)
+	{
+		if (description.colorAttachmentCount > gc_maxColorAttachments)
+		{
+			fail("too many color attachments (%d)", description.colorAttachmentCount);
+		}
+
+		auto it = m_renderPasses.find(description);
+		if (it != m_renderPasses.end())
+		{
+			return it->second;
+		}
+
+		VkAttachmentDescription attachmentDescriptions[gc_maxColorAttachments + 1];
+		VkAttachmentReference colorAttachmentReferences[gc_maxColorAttachments];
+		for (uint32_t i = 0; i < description.colorAttachmentCount; ++i)
+		{
+			attachmentDescriptions[i] = getAttachmentDescription(description.colorAttachments[i]);
+			colorAttachmentReferences[i] = {i, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+		}
+		auto attachmentCount = description.colorAttachmentCount;
+
+		VkAttachmentReference depthStencilAttachmentReference;
+		if (description.hasDepthStencilAttachment)
+		{
+			attachmentDescriptions[attachmentCount] = getAttachmentDescription(description.depthStencilAttachment);
+			depthStencilAttachmentReference = {attachmentCount++, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+		}
+
+		VkSubpassDescription subpassDescription;
+		subpassDescription.flags = 0;
+		subpassDescription.colorAttachmentCount = description.colorAttachmentCount;
+		subpassDescription.pColorAttachments = description.colorAttachmentCount > 0 ? colorAttachmentReferences : nullptr;
+		subpassDescription.pDepthStencilAttachment = description.hasDepthStencilAttachment ? &depthStencilAttachmentReference : nullptr;
+		subpassDescription.inputAttachmentCount = 0;
+		subpassDescription.pInputAttachments = nullptr;
+		subpassDescription.preserveAttachmentCount = 0;
+		subpassDescription.pPreserveAttachments = nullptr;
+		subpassDescription.pResolveAttachments = nullptr;
+		subpassDescription.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
+		// no external dependencies: synchronization with other passes is up to whoever records them (ie, the render graph)
+		VkRenderPassCreateInfo renderPassCreateInfo;
+		renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassCreateInfo.pNext = nullptr;
+		renderPassCreateInfo.flags = 0;
+		renderPassCreateInfo.attachmentCount = attachmentCount;
+		renderPassCreateInfo.pAttachments = attachmentCount > 0 ? attachmentDescriptions : nullptr;
+		renderPassCreateInfo.subpassCount = 1;
+		renderPassCreateInfo.pSubpasses = &subpassDescription;
+		renderPassCreateInfo.dependencyCount = 0;
+		renderPassCreateInfo.pDependencies = nullptr;
+
+		VkRenderPass renderPass;
+		vkfwCheckVkResult(vkCreateRenderPass(m_device, &renderPassCreateInfo, m_allocCb, &renderPass));
+
+		m_renderPasses.emplace(description, renderPass);
+
+		return renderPass;
+	}
+
+	void RenderPassCache::clear()
+	{
+		for (auto &entry : m_renderPasses)
+		{
+			vkDestroyRenderPass(m_device, entry.second, m_allocCb);
+		}
+		m_renderPasses.clear();
+	}
+
+}
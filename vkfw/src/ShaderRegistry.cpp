@@ -0,0 +1,33 @@
+#include <vkfw/ShaderRegistry.h>
+
+namespace vkfw
+{
+	void ShaderRegistry::add(const EmbeddedShader *embeddedShaders, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			const auto &embeddedShader = embeddedShaders[i];
+			m_shaders[embeddedShader.name] = {embeddedShader.code, embeddedShader.wordCount * sizeof(uint32_t)};
+		}
+	}
+
+	ShaderCode ShaderRegistry::get(const std::string &name)
+	{
+		auto it = m_shaders.find(name);
+		if (it != m_shaders.end())
+		{
+			return it->second;
+		}
+
+		MappedFile mappedFile("spirv/" + name + ".spv");
+		if (mappedFile.getData() == nullptr)
+		{
+			fail("couldn't find shader %s", name.c_str());
+		}
+		// mappings are page aligned
+		ShaderCode shaderCode{reinterpret_cast<const uint32_t *>(mappedFile.getData()), mappedFile.getSize()};
+		m_files.emplace_back(std::move(mappedFile));
+		return m_shaders[name] = shaderCode;
+	}
+
+}
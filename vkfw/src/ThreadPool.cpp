@@ -0,0 +1,118 @@
+#include <vkfw/ThreadPool.h>
+
+#include <algorithm>
+
+namespace vkfw
+{
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		for (uint32_t i = 0; i < threadCount; ++i)
+		{
+			m_threads.emplace_back(&ThreadPool::work, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_condition.notify_all();
+		for (auto &thread : m_threads)
+		{
+			thread.join();
+		}
+	}
+
+	void ThreadPool::work()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]()
+								 { return m_stopping || hasTasks(); });
+				if (!hasTasks())
+				{
+					return;
+				}
+				for (auto &tasks : m_tasks)
+				{
+					if (!tasks.empty())
+					{
+						task = std::move(tasks.front());
+						tasks.pop_front();
+						break;
+					}
+				}
+			}
+			task();
+		}
+	}
+
+	void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &function, TaskPriority priority)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// shared with the helpers, which can outlive this call if they only get dequeued after all the work is done
+		struct ParallelFor
+		{
+			std::function<void(size_t)> function;
+			size_t count;
+			std::atomic<size_t> next{0};
+			std::atomic<size_t> done{0};
+			std::mutex mutex;
+			std::condition_variable condition;
+
+			void run()
+			{
+				size_t i;
+				while ((i = next++) < count)
+				{
+					function(i);
+					if (++done == count)
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						condition.notify_all();
+					}
+				}
+			}
+		};
+
+		auto parallelFor = std::make_shared<ParallelFor>();
+		parallelFor->function = function;
+		parallelFor->count = count;
+
+		auto helperCount = std::min((size_t)getThreadCount(), count - 1);
+		for (size_t i = 0; i < helperCount; ++i)
+		{
+			enqueue([parallelFor]()
+					{ parallelFor->run(); },
+					priority);
+		}
+
+		parallelFor->run();
+
+		std::unique_lock<std::mutex> lock(parallelFor->mutex);
+		parallelFor->condition.wait(lock, [&parallelFor]()
+									{ return parallelFor->done == parallelFor->count; });
+	}
+
+	bool ThreadPool::hasTasks() const
+	{
+		for (const auto &tasks : m_tasks)
+		{
+			if (!tasks.empty())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+}
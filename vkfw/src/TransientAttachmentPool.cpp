@@ -0,0 +1,88 @@
+#include <vkfw/TransientAttachmentPool.h>
+
+namespace vkfw
+{
+	TransientAttachmentPool::TransientAttachmentPool(VkDevice device, const VkAllocationCallbacks *allocCb, FindMemoryTypeCb findMemoryTypeCb, uint32_t frameCount) : m_device(device),
+																																									   m_allocCb(allocCb),
+																																									   m_findMemoryTypeCb(std::move(findMemoryTypeCb)),
+																																									   m_frameCount(frameCount)
+	{
+	}
+
+	TransientAttachmentPool::~TransientAttachmentPool()
+	{
+		destroy();
+	}
+
+	void TransientAttachmentPool::recreate(VkFormat format, VkImageAspectFlags aspectMask, VkImageUsageFlags usage, uint32_t width, uint32_t height)
+	{
+		destroy();
+
+		m_attachments.resize(m_frameCount);
+		for (auto &attachment : m_attachments)
+		{
+			VkImageCreateInfo imageCreateInfo;
+			imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageCreateInfo.pNext = nullptr;
+			imageCreateInfo.flags = 0;
+			imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageCreateInfo.format = format;
+			imageCreateInfo.extent = {width, height, 1};
+			imageCreateInfo.mipLevels = 1;
+			imageCreateInfo.arrayLayers = 1;
+			imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageCreateInfo.usage = usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+			imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			imageCreateInfo.queueFamilyIndexCount = 0;
+			imageCreateInfo.pQueueFamilyIndices = nullptr;
+			imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+			vkfwCheckVkResult(vkCreateImage(m_device, &imageCreateInfo, m_allocCb, &attachment.image));
+
+			VkMemoryRequirements memoryRequirements;
+			vkGetImageMemoryRequirements(m_device, attachment.image, &memoryRequirements);
+
+			// fallback to regular device local memory on devices that don't offer lazily allocated memory (ie, most desktop GPUs)
+			auto memoryTypeIndex = m_findMemoryTypeCb(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+			m_lazilyAllocated = memoryTypeIndex != ~0u;
+			if (!m_lazilyAllocated)
+			{
+				memoryTypeIndex = m_findMemoryTypeCb(memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			}
+
+			VkMemoryAllocateInfo memoryAllocateInfo;
+			memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			memoryAllocateInfo.pNext = nullptr;
+			memoryAllocateInfo.allocationSize = memoryRequirements.size;
+			memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+			vkfwCheckVkResult(vkAllocateMemory(m_device, &memoryAllocateInfo, m_allocCb, &attachment.memory));
+			vkfwCheckVkResult(vkBindImageMemory(m_device, attachment.image, attachment.memory, 0));
+
+			VkImageViewCreateInfo imageViewCreateInfo;
+			imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			imageViewCreateInfo.pNext = nullptr;
+			imageViewCreateInfo.flags = 0;
+			imageViewCreateInfo.image = attachment.image;
+			imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			imageViewCreateInfo.format = format;
+			imageViewCreateInfo.components = {VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY};
+			imageViewCreateInfo.subresourceRange = {aspectMask, 0, 1, 0, 1};
+
+			vkfwCheckVkResult(vkCreateImageView(m_device, &imageViewCreateInfo, m_allocCb, &attachment.imageView));
+		}
+	}
+
+	void TransientAttachmentPool::destroy()
+	{
+		for (auto &attachment : m_attachments)
+		{
+			vkDestroyImageView(m_device, attachment.imageView, m_allocCb);
+			vkDestroyImage(m_device, attachment.image, m_allocCb);
+			vkFreeMemory(m_device, attachment.memory, m_allocCb);
+		}
+		m_attachments.clear();
+	}
+
+}